@@ -146,34 +146,51 @@ EventHandlerResult AutoShift::onKeyswitchEvent(KeyEvent &event) {
     // The key is eligible to be auto-shifted, so we add it to the queue and
     // defer processing of the event.
     queue_.append(event);
+    updateTimeoutTimer();
     return EventHandlerResult::ABORT;
   }
 
   return EventHandlerResult::OK;
 }
 
-// -----------------------------------------------------------------------------
-EventHandlerResult AutoShift::afterEachCycle() {
+// =============================================================================
+// Timeout handling
+
+void AutoShift::onTimeout(void *context) {
+  AutoShift &plugin = *static_cast<AutoShift *>(context);
   // If there's a pending AutoShift event, and it has timed out, we need to
   // release the event with the `shift` flag applied.
-  if (!queue_.isEmpty() &&
-      Runtime.hasTimeExpired(queue_.timestamp(0), settings_.timeout)) {
+  if (!plugin.queue_.isEmpty() &&
+      Runtime.hasTimeExpired(plugin.queue_.timestamp(0), plugin.settings_.timeout)) {
     // Toggle the state of the `SHIFT_HELD` bit in the modifier flags for the
     // key for the pending event.
-    flushEvent(true);
-    flushQueue();
+    plugin.flushEvent(true);
+    plugin.flushQueue();
   }
-  return EventHandlerResult::OK;
+  plugin.updateTimeoutTimer();
 }
 
+// Keep the timer in step with the event at the head of the queue, if any.
+void AutoShift::updateTimeoutTimer() {
+  if (queue_.isEmpty()) {
+    timeout_timer_.cancel();
+  } else {
+    timeout_timer_.startAt(queue_.timestamp(0), settings_.timeout);
+  }
+}
+
+// =============================================================================
+// Private helper functions
+
 void AutoShift::flushQueue() {
   while (!queue_.isEmpty()) {
     if (queue_.isRelease(0) || checkForRelease()) {
       flushEvent(false);
     } else {
-      return;
+      break;
     }
   }
+  updateTimeoutTimer();
 }
 
 bool AutoShift::checkForRelease() const {
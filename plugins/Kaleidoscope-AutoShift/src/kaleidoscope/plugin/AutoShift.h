@@ -27,6 +27,7 @@
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -164,6 +165,7 @@ class AutoShift : public Plugin {
   /// Sets the hold time required to trigger auto-shift (in ms)
   void setTimeout(uint16_t new_timeout) {
     settings_.timeout = new_timeout;
+    updateTimeoutTimer();
   }
 
   /// Returns the set of categories currently eligible for auto-shift
@@ -235,7 +237,6 @@ class AutoShift : public Plugin {
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  private:
   // ---------------------------------------------------------------------------
@@ -267,6 +268,13 @@ class AutoShift : public Plugin {
   // of `KeyAddr::none()`, so the plugin will start in an inactive state.
   KeyEvent pending_event_;
 
+  // Expires when the key press at the head of the queue has been held long
+  // enough to be auto-shifted.
+  Timer timeout_timer_{&AutoShift::onTimeout, this};
+
+  static void onTimeout(void *context);
+  void updateTimeoutTimer();
+
   void flushQueue();
   void flushEvent(bool is_long_press = false);
   bool checkForRelease() const;
@@ -33,6 +33,7 @@
 #include "kaleidoscope/progmem_helpers.h"       // for cloneFromProgmem
 #include "kaleidoscope/keyswitch_state.h"       // for keyToggledOn
 #include "kaleidoscope/Runtime.h"               // for Runtime
+#include "kaleidoscope/Scheduler.h"             // for Timer
 
 namespace kaleidoscope {
 namespace plugin {
@@ -50,6 +51,7 @@ EventHandlerResult Chord::onKeyswitchEvent(KeyEvent &event) {
 
   if (isChordStrictSubset()) {
     start_time_ = Runtime.millisAtCycleStart();
+    timeout_timer_.start(timeout_);
     return EventHandlerResult::ABORT;
   }
 
@@ -66,15 +68,17 @@ EventHandlerResult Chord::onKeyswitchEvent(KeyEvent &event) {
   return EventHandlerResult::OK;
 }
 
-EventHandlerResult Chord::afterEachCycle() {
-  if (Runtime.hasTimeExpired(start_time_, timeout_) && potential_chord_size_ > 0) {
-    resolveOrArpeggiate();
+void Chord::onTimeout(void *context) {
+  Chord &plugin = *static_cast<Chord *>(context);
+  if (plugin.potential_chord_size_ > 0) {
+    plugin.resolveOrArpeggiate();
   }
-  return EventHandlerResult::OK;
 }
 
 void Chord::setTimeout(uint8_t timeout) {
   timeout_ = timeout;
+  if (timeout_timer_.isActive())
+    timeout_timer_.startAt(start_time_, timeout_);
 }
 
 void Chord::resolveOrArpeggiate() {
@@ -27,6 +27,7 @@
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
 #include "kaleidoscope/key_defs.h"              // for Key, Key_Transparent
@@ -38,7 +39,6 @@ namespace plugin {
 class Chord : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
   void setTimeout(uint8_t timeout);
 
   template<uint8_t _chord_defs_size>
@@ -58,9 +58,11 @@ class Chord : public kaleidoscope::Plugin {
   Key getChord();
   void appendEvent(KeyEvent event);
   void arpeggiate();
+  static void onTimeout(void *context);
 
   KeyEventTracker event_tracker_;
   uint16_t start_time_;
+  Timer timeout_timer_{&Chord::onTimeout, this};
 
   static constexpr uint8_t kMaxChordSize{10};
   KeyEvent potential_chord_[kMaxChordSize];
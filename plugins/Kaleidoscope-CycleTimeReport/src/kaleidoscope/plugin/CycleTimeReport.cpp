@@ -22,12 +22,14 @@
 
 #include "kaleidoscope/plugin/CycleTimeReport.h"
 
-#include <Arduino.h>                   // for micros, F, __FlashStringHelper
+#include <Arduino.h>                   // for micros, F, PSTR, __FlashStringHelper
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
-#include <stdint.h>                    // for uint16_t, uint32_t
+#include <stdint.h>                    // for uint8_t, uint16_t, uint32_t
 
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/hook_profile.h"          // for HookStats, pluginCount, stats, reset
+#include "kaleidoscope/latency_histogram.h"     // for bucket, bucketCount, bucketMicros, count
 
 namespace kaleidoscope {
 namespace plugin {
@@ -56,6 +58,69 @@ EventHandlerResult CycleTimeReport::beforeEachCycle() {
   return EventHandlerResult::OK;
 }
 
+// The `profile.hooks` command sends one line for each hook implemented by
+// each plugin: the plugin, the hook, the number of calls, and the total and
+// longest time spent in those calls, in microseconds. It only has anything to
+// report if the sketch was built with `KALEIDOSCOPE_HOOK_PROFILING` enabled.
+//
+// The `profile.latency` command sends two lines: the number of keyswitch
+// events recorded, the 50th and 99th percentile and the longest of their
+// latencies, in microseconds; then the width of a histogram bucket, followed
+// by the number of events in each bucket. It only has anything to report if
+// the sketch was built with `KALEIDOSCOPE_LATENCY_HISTOGRAM` enabled.
+//
+// The `profile.reset` command clears both.
+EventHandlerResult CycleTimeReport::onFocusEvent(const char *input) {
+  const char *cmd_hooks   = PSTR("profile.hooks");
+  const char *cmd_latency = PSTR("profile.latency");
+  const char *cmd_reset   = PSTR("profile.reset");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_hooks, cmd_latency, cmd_reset);
+
+  if (::Focus.inputMatchesCommand(input, cmd_reset)) {
+    hook_profile::reset();
+    latency_histogram::reset();
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_latency)) {
+    if (latency_histogram::bucketCount() == 0)
+      return EventHandlerResult::EVENT_CONSUMED;
+
+    ::Focus.send(latency_histogram::count(),
+                 latency_histogram::percentile(50),
+                 latency_histogram::percentile(99));
+    ::Focus.sendRaw(latency_histogram::maxMicros(), ::Focus.NEWLINE);
+    ::Focus.send(latency_histogram::bucketMicros());
+    uint8_t last = latency_histogram::bucketCount() - 1;
+    for (uint8_t i = 0; i < last; ++i)
+      ::Focus.send(latency_histogram::bucket(i));
+    ::Focus.sendRaw(latency_histogram::bucket(last), ::Focus.NEWLINE);
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (!::Focus.inputMatchesCommand(input, cmd_hooks))
+    return EventHandlerResult::OK;
+
+  char plugin_name[32];
+  char hook_name[32];
+  for (uint8_t plugin = 0; plugin < hook_profile::pluginCount(); ++plugin) {
+    hook_profile::pluginName(plugin, plugin_name, sizeof(plugin_name));
+    for (uint8_t hook = 0; hook < hook_profile::hook_count; ++hook) {
+      hook_profile::HookStats stats =
+        hook_profile::stats(plugin, hook_profile::Hook(hook));
+      if (stats.calls == 0)
+        continue;
+      hook_profile::hookName(hook_profile::Hook(hook), hook_name, sizeof(hook_name));
+      ::Focus.send(plugin_name, hook_name, stats.calls, stats.total_us);
+      ::Focus.sendRaw(stats.max_us, ::Focus.NEWLINE);
+    }
+  }
+
+  return EventHandlerResult::EVENT_CONSUMED;
+}
+
 __attribute__((weak)) void CycleTimeReport::report(uint16_t mean_cycle_time) {
   Focus.send(Focus.COMMENT,
              F("mean cycle time:"),
@@ -41,6 +41,7 @@ namespace plugin {
 class CycleTimeReport : public kaleidoscope::Plugin {
  public:
   EventHandlerResult beforeEachCycle();
+  EventHandlerResult onFocusEvent(const char *input);
 
 #ifndef NDEPRECATED
   DEPRECATED(CYCLETIMEREPORT_AVG_TIME)
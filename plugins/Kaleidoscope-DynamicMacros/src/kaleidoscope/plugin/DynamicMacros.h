@@ -43,6 +43,7 @@ constexpr Key DynamicMacrosKey(uint8_t n) {
 class DynamicMacros : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onNameQuery();
+  using KeyEventRange = KeyRange<ranges::DYNAMIC_MACRO_FIRST, ranges::DYNAMIC_MACRO_LAST>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult onFocusEvent(const char *input);
   EventHandlerResult beforeReportingState(const KeyEvent &event) {
@@ -40,6 +40,12 @@ uint16_t EEPROMKeymap::keymap_base_;
 uint8_t EEPROMKeymap::max_layers_;
 uint8_t EEPROMKeymap::progmem_layers_;
 
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+KeyMap EEPROMKeymap::cache_[EEPROM_KEYMAP_CACHE_LAYERS];
+bool EEPROMKeymap::cache_valid_;
+uint8_t EEPROMKeymap::cache_storage_generation_;
+#endif
+
 EventHandlerResult EEPROMKeymap::onSetup() {
   progmem_layers_ = layer_count;
   return EventHandlerResult::OK;
@@ -63,12 +69,25 @@ void EEPROMKeymap::setup(uint8_t max) {
 void EEPROMKeymap::max_layers(uint8_t max) {
   max_layers_  = max;
   keymap_base_ = ::EEPROMSettings.requestSlice(max_layers_ * Runtime.device().numKeys() * 2);
+  invalidateCache();
 }
 
 Key EEPROMKeymap::getKey(uint8_t layer, KeyAddr key_addr) {
   if (layer >= max_layers_)
     return Key_NoKey;
 
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+  if (layer < EEPROM_KEYMAP_CACHE_LAYERS) {
+    if (!cacheIsCurrent())
+      loadCache();
+    return cache_[layer][key_addr];
+  }
+#endif
+
+  return readKey(layer, key_addr);
+}
+
+Key EEPROMKeymap::readKey(uint8_t layer, KeyAddr key_addr) {
   uint16_t pos = ((layer * Runtime.device().numKeys()) + key_addr.toInt()) * 2;
 
   return Key(Runtime.storage().read(keymap_base_ + pos + 1),  // key_code
@@ -90,9 +109,50 @@ uint16_t EEPROMKeymap::keymap_base() {
   return keymap_base_;
 }
 
+void EEPROMKeymap::invalidateCache() {
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+  cache_valid_ = false;
+#endif
+}
+
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+// The cache is out of date if storage has been erased or overwritten since it
+// was loaded (see `EEPROMSettings::storageChanged()`).
+bool EEPROMKeymap::cacheIsCurrent() {
+  return cache_valid_ &&
+         cache_storage_generation_ == ::EEPROMSettings.storageGeneration();
+}
+
+void EEPROMKeymap::loadCache() {
+  for (uint8_t layer = 0; layer < EEPROM_KEYMAP_CACHE_LAYERS && layer < max_layers_; ++layer) {
+    for (auto key_addr : KeyAddr::all()) {
+      cache_[layer][key_addr] = readKey(layer, key_addr);
+    }
+  }
+  cache_storage_generation_ = ::EEPROMSettings.storageGeneration();
+  cache_valid_              = true;
+}
+#endif
+
 void EEPROMKeymap::updateKey(uint16_t base_pos, Key key) {
   Runtime.storage().update(keymap_base_ + base_pos * 2, key.getFlags());
   Runtime.storage().update(keymap_base_ + base_pos * 2 + 1, key.getKeyCode());
+
+  uint8_t layer = base_pos / Runtime.device().numKeys();
+  KeyAddr key_addr(uint8_t(base_pos % Runtime.device().numKeys()));
+
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+  // Write through to the cache. If it isn't current, it will be reloaded in
+  // full on the next lookup anyway.
+  if (layer < EEPROM_KEYMAP_CACHE_LAYERS && cacheIsCurrent())
+    cache_[layer][key_addr] = key;
+#endif
+
+  // Let the layer code know that the keymap has changed. When the PROGMEM
+  // layers come first, EEPROM layer numbers are offset by their count.
+  if (Layer.getKey == getKeyExtended)
+    layer += progmem_layers_;
+  Layer.updateLayerCoverage(layer, key_addr);
 }
 
 void EEPROMKeymap::dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr)) {
@@ -25,10 +25,23 @@
 #include <stdint.h>  // for uint8_t, uint16_t
 
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
+#include "kaleidoscope/KeyMap.h"                // for KeyMap
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
 
+// The number of custom layers that are kept in RAM, so that looking up a key
+// doesn't need to read it from storage. Every cached layer costs two bytes per
+// key, so this is disabled by default on AVR, where RAM is scarce. Layers above
+// this limit are read from storage.
+#ifndef EEPROM_KEYMAP_CACHE_LAYERS
+#ifdef __AVR__
+#define EEPROM_KEYMAP_CACHE_LAYERS 0
+#else
+#define EEPROM_KEYMAP_CACHE_LAYERS 8
+#endif
+#endif
+
 namespace kaleidoscope {
 namespace plugin {
 class EEPROMKeymap : public kaleidoscope::Plugin {
@@ -53,11 +66,27 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
 
   static void updateKey(uint16_t base_pos, Key key);
 
+  // Drop the cached copy of the custom layers, so that they are read from
+  // storage again on the next lookup. This is only needed if the keymap in
+  // storage was changed without using `updateKey()`.
+  static void invalidateCache();
+
  private:
   static uint16_t keymap_base_;
   static uint8_t max_layers_;
   static uint8_t progmem_layers_;
 
+  static Key readKey(uint8_t layer, KeyAddr key_addr);
+
+#if EEPROM_KEYMAP_CACHE_LAYERS > 0
+  static KeyMap cache_[EEPROM_KEYMAP_CACHE_LAYERS];
+  static bool cache_valid_;
+  static uint8_t cache_storage_generation_;
+
+  static bool cacheIsCurrent();
+  static void loadCache();
+#endif
+
   static Key parseKey();
   static void printKey(Key key);
   static void dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr));
@@ -231,12 +231,16 @@ EventHandlerResult FocusEEPROMCommand::onFocusEvent(const char *input) {
         Runtime.storage().update(i, d);
       }
       Runtime.storage().commit();
+      ::EEPROMSettings.storageChanged();
+      // The raw contents might include keymap layers stored in EEPROM.
+      Layer.updateLayerCoverage();
     }
   } else if (::Focus.inputMatchesCommand(input, cmd_free)) {
     ::Focus.send(Runtime.storage().length() - ::EEPROMSettings.used());
   } else if (::Focus.inputMatchesCommand(input, cmd_erase)) {
 
     Runtime.storage().erase();
+    ::EEPROMSettings.storageChanged();
     Runtime.device().rebootBootloader();
   } else {
     return EventHandlerResult::OK;
@@ -78,6 +78,17 @@ class EEPROMSettings : public kaleidoscope::Plugin {
   bool ignoreHardcodedLayers() {
     return settings_.ignore_hardcoded_layers;
   }
+
+  // Plugins that keep a copy of their data from storage in RAM can compare the
+  // storage generation against the one they loaded their copy at, to find out
+  // if storage has been erased or overwritten since. Whoever changes storage
+  // wholesale, bypassing the plugins that own it, must call `storageChanged()`.
+  void storageChanged() {
+    storage_generation_++;
+  }
+  uint8_t storageGeneration() {
+    return storage_generation_;
+  }
   // get a settings slice from the storage and stick it in the settings struct
   // Takes a pointer to the start address, and a pointer to the data structure for settings
   // startAddress is the address of the start of the slice, to be returned to the caller
@@ -108,6 +119,7 @@ class EEPROMSettings : public kaleidoscope::Plugin {
   uint16_t next_start_ = sizeof(EEPROMSettings::Settings);
   bool is_valid_;
   bool sealed_;
+  uint8_t storage_generation_ = 0;
 
   Settings settings_;
 };
@@ -79,6 +79,7 @@ const uint8_t KeyScannerProps::matrix_rows;
 const uint8_t KeyScannerProps::matrix_columns;
 constexpr uint8_t KeyScannerProps::matrix_row_pins[matrix_rows];
 constexpr uint8_t KeyScannerProps::matrix_col_pins[matrix_columns];
+constexpr uint8_t KeyScannerProps::idle_sense_pins[];
 constexpr uint8_t LEDDriverProps::key_led_map[];
 
 // Initialize static members
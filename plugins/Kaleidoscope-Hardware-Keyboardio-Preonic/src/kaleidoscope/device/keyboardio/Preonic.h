@@ -214,12 +214,16 @@ struct PreonicStorageProps : public kaleidoscope::driver::storage::NRF52FlashPro
 
 struct PreonicKeyScannerProps : public kaleidoscope::driver::keyscanner::NRF52KeyScannerProps {
   static constexpr uint32_t keyscan_interval_micros = 750;
+  static constexpr uint16_t idle_timeout_millis     = 100;
   static constexpr uint8_t matrix_rows              = 6;
   static constexpr uint8_t matrix_columns           = 12;
   typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
   typedef uint16_t RowState;
   static constexpr uint8_t matrix_row_pins[matrix_rows]    = {0, 1, 2, 3, 4, 5};
   static constexpr uint8_t matrix_col_pins[matrix_columns] = {6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+  // The encoder pins are sensed once the keyboard has been asleep.
+  static constexpr uint8_t idle_sense_pins[2 * NUM_ENCODERS] = {
+    PIN_ENC1_A, PIN_ENC1_B, PIN_ENC2_A, PIN_ENC2_B, PIN_ENC3_A, PIN_ENC3_B};
 };
 
 // If we need to override HID props:
@@ -0,0 +1,136 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-HardwareFocus -- Focus commands to inspect and tune the hardware drivers
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/HardwareFocus.h"
+
+#include <Arduino.h>                   // for PSTR, F, __FlashStringHelper
+#include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
+#include <stdint.h>                    // for uint8_t, uint16_t
+
+#include "kaleidoscope/KeyAddr.h"               // for KeyAddr, MatrixAddr<>::Range
+#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"         // for Device
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
+
+namespace kaleidoscope {
+namespace plugin {
+
+EventHandlerResult HardwareFocus::onNameQuery() {
+  return ::Focus.sendName(F("HardwareFocus"));
+}
+
+EventHandlerResult HardwareFocus::onFocusEvent(const char *input) {
+  const char *cmd_chatter = PSTR("hardware.chatter");
+  const char *cmd_window  = PSTR("hardware.chatter.window");
+  const char *cmd_reset   = PSTR("hardware.chatter.reset");
+  const char *cmd_rate    = PSTR("hardware.scan_interval");
+  const char *cmd_fast    = PSTR("hardware.scan_interval.fast");
+  const char *cmd_slow    = PSTR("hardware.scan_interval.slow");
+  const char *cmd_decay   = PSTR("hardware.scan_interval.decay");
+  const char *cmd_queue   = PSTR("hardware.hid_queue");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_chatter, cmd_window, cmd_reset,
+                             cmd_rate, cmd_fast, cmd_slow, cmd_decay,
+                             cmd_queue);
+
+  auto &key_scanner = Runtime.device().keyScanner();
+
+  if (::Focus.inputMatchesCommand(input, cmd_chatter)) {
+    for (auto key_addr : KeyAddr::all()) {
+      uint8_t count = key_scanner.chatterCount(key_addr);
+      if (count == 0)
+        continue;
+      ::Focus.send(key_addr.row(), key_addr.col());
+      ::Focus.sendRaw(count, ::Focus.NEWLINE);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_window)) {
+    if (::Focus.isEOL()) {
+      ::Focus.send(key_scanner.chatterWindow());
+    } else {
+      uint8_t window;
+      ::Focus.read(window);
+      key_scanner.setChatterWindow(window);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_reset)) {
+    key_scanner.resetChatterCounts();
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_queue)) {
+    auto stats = Runtime.device().hid().reportQueueStats();
+    ::Focus.send(stats.queued, stats.coalesced, stats.dropped);
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  // The scan interval commands are only there for key scanners with an
+  // adaptive scan rate.
+  auto *scan_rate = key_scanner.scanRate();
+  if (scan_rate == nullptr)
+    return EventHandlerResult::OK;
+
+  if (::Focus.inputMatchesCommand(input, cmd_rate)) {
+    ::Focus.send(scan_rate->interval());
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_fast)) {
+    if (::Focus.isEOL()) {
+      ::Focus.send(scan_rate->fastInterval());
+    } else {
+      uint16_t interval;
+      ::Focus.read(interval);
+      scan_rate->setFastInterval(interval);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_slow)) {
+    if (::Focus.isEOL()) {
+      ::Focus.send(scan_rate->slowInterval());
+    } else {
+      uint16_t interval;
+      ::Focus.read(interval);
+      scan_rate->setSlowInterval(interval);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  if (::Focus.inputMatchesCommand(input, cmd_decay)) {
+    if (::Focus.isEOL()) {
+      ::Focus.send(scan_rate->decay());
+    } else {
+      uint16_t decay;
+      ::Focus.read(decay);
+      scan_rate->setDecay(decay);
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+  return EventHandlerResult::OK;
+}
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::HardwareFocus HardwareFocus;
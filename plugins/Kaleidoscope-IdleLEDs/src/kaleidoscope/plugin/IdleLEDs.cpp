@@ -25,6 +25,7 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/device/device.h"         // for VirtualProps::Storage, Base<>::Storage
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/plugin/LEDControl.h"     // for LEDControl
@@ -35,6 +36,7 @@ namespace plugin {
 uint32_t IdleLEDs::idle_time_limit = 600000;  // 10 minutes
 uint32_t IdleLEDs::start_time_     = 0;
 bool IdleLEDs::idle_;
+Timer IdleLEDs::idle_timer_{&IdleLEDs::onIdleTimeout};
 
 uint32_t IdleLEDs::idleTimeoutSeconds() {
   return idle_time_limit / 1000;
@@ -42,19 +44,37 @@ uint32_t IdleLEDs::idleTimeoutSeconds() {
 
 void IdleLEDs::setIdleTimeoutSeconds(uint32_t new_limit) {
   idle_time_limit = new_limit * 1000;
+  updateIdleTimer();
 }
 
-EventHandlerResult IdleLEDs::beforeEachCycle() {
+EventHandlerResult IdleLEDs::onSetup() {
+  updateIdleTimer();
+  return EventHandlerResult::OK;
+}
+
+void IdleLEDs::onIdleTimeout(void *) {
+  // `idle_time_limit` can be changed without going through
+  // `setIdleTimeoutSeconds()`, so check it again.
   if (idle_time_limit == 0)
-    return EventHandlerResult::OK;
+    return;
+  if (!Runtime.hasTimeExpired(start_time_, idle_time_limit)) {
+    updateIdleTimer();
+    return;
+  }
 
-  if (::LEDControl.isEnabled() &&
-      Runtime.hasTimeExpired(start_time_, idle_time_limit)) {
+  if (::LEDControl.isEnabled()) {
     ::LEDControl.disable();
     idle_ = true;
   }
+}
 
-  return EventHandlerResult::OK;
+// Keep the timer in step with the last key event and the time limit.
+void IdleLEDs::updateIdleTimer() {
+  if (idle_time_limit == 0) {
+    idle_timer_.cancel();
+  } else {
+    idle_timer_.startAt(start_time_, idle_time_limit);
+  }
 }
 
 EventHandlerResult IdleLEDs::onKeyEvent(KeyEvent &event) {
@@ -64,6 +84,7 @@ EventHandlerResult IdleLEDs::onKeyEvent(KeyEvent &event) {
   }
 
   start_time_ = Runtime.millisAtCycleStart();
+  updateIdleTimer();
 
   return EventHandlerResult::OK;
 }
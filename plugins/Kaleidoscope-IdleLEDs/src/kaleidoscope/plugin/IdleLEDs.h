@@ -21,6 +21,7 @@
 #include <stdint.h>  // for uint32_t, uint16_t
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
 
@@ -34,12 +35,18 @@ class IdleLEDs : public kaleidoscope::Plugin {
   static uint32_t idleTimeoutSeconds();
   static void setIdleTimeoutSeconds(uint32_t new_limit);
 
-  EventHandlerResult beforeEachCycle();
+  EventHandlerResult onSetup();
   EventHandlerResult onKeyEvent(KeyEvent &event);
 
  private:
   static bool idle_;
   static uint32_t start_time_;
+
+  // Expires when `idle_time_limit` has passed since the last key event.
+  static Timer idle_timer_;
+
+  static void onIdleTimeout(void *context);
+  static void updateIdleTimer();
 };
 
 class PersistentIdleLEDs : public IdleLEDs {
@@ -63,7 +63,7 @@ EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
       mod_key_bits_.set(event.addr);
     }
     if (event.key == OneShot_ActiveStickyKey) {
-      for (KeyAddr entry_addr : KeyAddr::all()) {
+      for (KeyAddr entry_addr : live_keys.activeKeys()) {
         // Get the entry from the live keys array
         Key entry_key = live_keys[entry_addr];
         // Skip empty entries
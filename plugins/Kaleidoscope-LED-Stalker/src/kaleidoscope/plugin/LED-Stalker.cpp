@@ -27,7 +27,7 @@
 
 #include "kaleidoscope/KeyAddr.h"                     // for MatrixAddr, KeyAddr, MatrixAddr<>::...
 #include "kaleidoscope/KeyEvent.h"                    // for KeyEvent
-#include "kaleidoscope/LiveKeys.h"                    // for live_keys
+#include "kaleidoscope/LiveKeys.h"                    // for LiveKeys, live_keys
 #include "kaleidoscope/Runtime.h"                     // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"               // for cRGB, CRGB
 #include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult, EventHandlerRes...
@@ -57,11 +57,15 @@ void StalkerEffect::TransientLEDMode::update() {
   if (!Runtime.hasTimeExpired(step_start_time_, parent_->step_length))
     return;
 
+  // Read-only view of the live keys, so that checking every entry doesn't flag
+  // all of them as (possibly) active.
+  const LiveKeys &keys = live_keys;
+
   for (auto key_addr : KeyAddr::all()) {
     uint8_t step = map_[key_addr.toInt()];
 
     // If key is active (held), set its animation position to the start
-    if (live_keys[key_addr] != Key_Inactive) {
+    if (keys[key_addr] != Key_Inactive) {
       step = 0xff;
     }
 
@@ -43,6 +43,7 @@ constexpr uint8_t BRIGHTNESS_INCREMENT = 16;
 class LEDBrightnessControl : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onNameQuery();
+  using KeyEventRange = KeyRange<ranges::LED_BRIGHTNESS_UP, ranges::LED_BRIGHTNESS_DOWN>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
 };
 
@@ -31,6 +31,7 @@
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
 #include "kaleidoscope/keyswitch_state.h"       // for INJECTED, keyToggledOff
@@ -85,11 +86,28 @@ int8_t Leader::lookup() {
   return NO_MATCH;
 }
 
+uint16_t Leader::timeout() const {
+#ifndef NDEPRECATED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+  return time_out;
+#pragma GCC diagnostic pop
+#else
+  return timeout_;
+#endif
+}
+
+void Leader::startTimeoutTimer() {
+  start_time_ = Runtime.millisAtCycleStart();
+  timeout_timer_.start(timeout());
+}
+
 // --- api ---
 
 void Leader::reset() {
   sequence_pos_ = 0;
   sequence_[0]  = Key_NoKey;
+  timeout_timer_.cancel();
 }
 
 #ifndef NDEPRECATED
@@ -116,7 +134,7 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     if (!isLeader(event.key))
       return EventHandlerResult::OK;
 
-    start_time_              = Runtime.millisAtCycleStart();
+    startTimeoutTimer();
     sequence_pos_            = 0;
     sequence_[sequence_pos_] = event.key;
 
@@ -129,7 +147,7 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     return EventHandlerResult::OK;
   }
 
-  start_time_              = Runtime.millisAtCycleStart();
+  startTimeoutTimer();
   sequence_[sequence_pos_] = event.key;
   int8_t action_index      = lookup();
 
@@ -148,22 +166,30 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
   return EventHandlerResult::ABORT;
 }
 
-EventHandlerResult Leader::afterEachCycle() {
-  if (!isActive())
-    return EventHandlerResult::OK;
-
 #ifndef NDEPRECATED
+// Sketches can still assign to the deprecated `time_out` variable directly,
+// which the timer wouldn't notice, so we pick up the new value here.
+EventHandlerResult Leader::afterEachCycle() {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time_, time_out))
-    reset();
+  if (time_out != timeout_)
+    setTimeout(time_out);
 #pragma GCC diagnostic pop
-#else
-  if (Runtime.hasTimeExpired(start_time_, timeout_))
-    reset();
+  return EventHandlerResult::OK;
+}
 #endif
 
-  return EventHandlerResult::OK;
+void Leader::onTimeout(void *context) {
+  Leader &plugin = *static_cast<Leader *>(context);
+  if (plugin.sequence_[0] == Key_NoKey)
+    return;
+
+  // The timeout might have been changed since the timer was started.
+  if (Runtime.hasTimeExpired(plugin.start_time_, plugin.timeout())) {
+    plugin.reset();
+  } else {
+    plugin.timeout_timer_.startAt(plugin.start_time_, plugin.timeout());
+  }
 }
 
 }  // namespace plugin
@@ -28,6 +28,7 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -94,11 +95,15 @@ class Leader : public kaleidoscope::Plugin {
 #pragma GCC diagnostic pop
 #endif
     timeout_ = timeout;
+    if (timeout_timer_.isActive())
+      timeout_timer_.startAt(start_time_, timeout);
   }
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
+#ifndef NDEPRECATED
   EventHandlerResult afterEachCycle();
+#endif
 
  private:
   Key sequence_[LEADER_MAX_SEQUENCE_LENGTH + 1];
@@ -107,6 +112,13 @@ class Leader : public kaleidoscope::Plugin {
   uint16_t start_time_ = 0;
   uint16_t timeout_    = 1000;
 
+  // Expires when the current sequence has timed out.
+  Timer timeout_timer_{&Leader::onTimeout, this};
+
+  static void onTimeout(void *context);
+  uint16_t timeout() const;
+  void startTimeoutTimer();
+
   int8_t lookup();
 };
 
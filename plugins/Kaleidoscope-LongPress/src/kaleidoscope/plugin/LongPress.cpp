@@ -149,6 +149,7 @@ EventHandlerResult LongPress::onKeyswitchEvent(KeyEvent &event) {
     // be auto-shifted, so we add it to the queue and defer processing of
     // the event.
     queue_.append(event);
+    updateTimeoutTimer();
     return EventHandlerResult::ABORT;
   }
 
@@ -196,17 +197,27 @@ bool LongPress::isExplicitlyMapped(KeyAddr addr, Key key) {
 
 
 // -----------------------------------------------------------------------------
-EventHandlerResult LongPress::afterEachCycle() {
+void LongPress::onTimeout(void *context) {
+  LongPress &plugin = *static_cast<LongPress *>(context);
   // If there's a pending LongPress event, and it has timed out, we need to
   // release the event with the `shift` flag applied.
-  if (!queue_.isEmpty() &&
-      Runtime.hasTimeExpired(queue_.timestamp(0), settings_.timeout)) {
+  if (!plugin.queue_.isEmpty() &&
+      Runtime.hasTimeExpired(plugin.queue_.timestamp(0), plugin.settings_.timeout)) {
     // Toggle the state of the `SHIFT_HELD` bit in the modifier flags for the
     // key for the pending event.
-    flushEvent(true);
-    flushQueue();
+    plugin.flushEvent(true);
+    plugin.flushQueue();
+  }
+  plugin.updateTimeoutTimer();
+}
+
+// Keep the timer in step with the event at the head of the queue, if any.
+void LongPress::updateTimeoutTimer() {
+  if (queue_.isEmpty()) {
+    timeout_timer_.cancel();
+  } else {
+    timeout_timer_.startAt(queue_.timestamp(0), settings_.timeout);
   }
-  return EventHandlerResult::OK;
 }
 
 void LongPress::flushQueue() {
@@ -214,9 +225,10 @@ void LongPress::flushQueue() {
     if (queue_.isRelease(0) || checkForRelease()) {
       flushEvent(false);
     } else {
-      return;
+      break;
     }
   }
+  updateTimeoutTimer();
 }
 
 bool LongPress::checkForRelease() const {
@@ -95,6 +95,7 @@ class Macros : public kaleidoscope::Plugin {
   // ---------------------------------------------------------------------------
   // Event handlers
   EventHandlerResult onNameQuery();
+  using KeyEventRange = KeyRange<ranges::MACRO_FIRST, ranges::MACRO_LAST>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult beforeReportingState(const KeyEvent &event) {
     return ::MacroSupport.beforeReportingState(event);
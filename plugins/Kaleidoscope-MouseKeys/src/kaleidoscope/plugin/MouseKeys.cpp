@@ -114,18 +114,35 @@ EventHandlerResult MouseKeys::afterEachCycle() {
   if (directions_ == 0)
     return EventHandlerResult::OK;
 
+  // Movement is worked out from the time that has actually passed since the
+  // last update, so that it doesn't slow down when a cycle takes longer than
+  // the update interval. Cursor and wheel movement that are due in the same
+  // cycle go out in a single report.
+  uint8_t now         = Runtime.millisAtCycleStart();
+  uint8_t cursor_time = 0;
+  uint8_t wheel_steps = 0;
+
   // Check timeout for position update interval.
   if (Runtime.hasTimeExpired(last_cursor_update_time_, cursor_update_interval_)) {
-    sendMouseMoveReport();
-    last_cursor_update_time_ += cursor_update_interval_;
+    cursor_time              = now - last_cursor_update_time_;
+    last_cursor_update_time_ = now;
   }
 
-  // Check timeout for scroll report interval.
-  if (Runtime.hasTimeExpired(last_wheel_update_time_, settings_.wheel_update_interval)) {
-    sendMouseWheelReport();
-    last_wheel_update_time_ += settings_.wheel_update_interval;
+  // Check timeout for scroll report interval. The time left over after the
+  // last whole step carries over to the next one.
+  uint8_t wheel_interval = settings_.wheel_update_interval;
+  if (Runtime.hasTimeExpired(last_wheel_update_time_, wheel_interval)) {
+    if (wheel_interval == 0) {
+      wheel_steps = 1;
+    } else {
+      wheel_steps = uint8_t(now - last_wheel_update_time_) / wheel_interval;
+      last_wheel_update_time_ += wheel_steps * wheel_interval;
+    }
   }
 
+  if (cursor_time != 0 || wheel_steps != 0)
+    sendMouseMoveReport(cursor_time, wheel_steps);
+
   return EventHandlerResult::OK;
 }
 
@@ -175,6 +192,7 @@ EventHandlerResult MouseKeys::afterReportingState(const KeyEvent &event) {
   // begin correctly.
   if ((directions_ & cursor_mask_) == 0) {
     cursor_start_time_ = Runtime.millisAtCycleStart();
+    cursor_subpixels_  = 0;
   }
 
   // A mouse key event has been successfully registered, and we have now
@@ -185,10 +203,10 @@ EventHandlerResult MouseKeys::afterReportingState(const KeyEvent &event) {
 
   if (keyToggledOn(event.state)) {
     if (isMouseMoveKey(event.key)) {
-      sendMouseMoveReport();
+      sendMouseMoveReport(cursor_update_interval_, 0);
       last_cursor_update_time_ = Runtime.millisAtCycleStart();
     } else if (isMouseWheelKey(event.key)) {
-      sendMouseWheelReport();
+      sendMouseMoveReport(0, 1);
       last_wheel_update_time_ = Runtime.millisAtCycleStart();
     }
   }
@@ -239,17 +257,20 @@ void MouseKeys::sendMouseWarpReport(const KeyEvent &event) const {
 }
 
 // -----------------------------------------------------------------------------
-void MouseKeys::sendMouseMoveReport() const {
+// Send a report with the cursor movement for `cursor_time` milliseconds, and
+// `wheel_steps` steps of the scroll wheel, in the active directions. The wheel
+// moves one step per `wheel_update_interval`; wheel speed should be controlled
+// by changing that interval.
+void MouseKeys::sendMouseMoveReport(uint8_t cursor_time, uint8_t wheel_steps) {
   int8_t dx = 0;
   int8_t dy = 0;
+  int8_t dv = 0;
+  int8_t dh = 0;
 
   uint8_t direction = directions_ & cursor_mask_;
 
-  if (direction != 0) {
-    // Calculate
-    uint8_t delta = cursorDelta();
-    // For each active direction, add the move update interval value to
-    // normalize speed of motion regardless of the frequency of updates.
+  if (direction != 0 && cursor_time != 0) {
+    uint8_t delta = cursorDelta(cursor_time);
     if (direction & KEY_MOUSE_LEFT)
       dx -= delta;
     if (direction & KEY_MOUSE_RIGHT)
@@ -258,11 +279,28 @@ void MouseKeys::sendMouseMoveReport() const {
       dy -= delta;
     if (direction & KEY_MOUSE_DOWN)
       dy += delta;
+  }
+
+  direction = directions_ >> wheel_offset_;
 
-    // Send the report.
-    Runtime.hid().mouse().move(dx, dy, 0, 0);
-    Runtime.hid().mouse().sendReport();
+  if (direction != 0 && wheel_steps != 0) {
+    int8_t steps = wheel_steps > 127 ? 127 : wheel_steps;
+    // Horizontal scroll wheel:
+    if (direction & KEY_MOUSE_LEFT)
+      dh -= steps;
+    if (direction & KEY_MOUSE_RIGHT)
+      dh += steps;
+    // Vertical scroll wheel (note coordinates are opposite movement):
+    if (direction & KEY_MOUSE_UP)
+      dv += steps;
+    if (direction & KEY_MOUSE_DOWN)
+      dv -= steps;
   }
+
+  // Send the report. If the subpixel remainder didn't add up to a whole pixel
+  // yet, and the wheel isn't moving, nothing is sent.
+  Runtime.hid().mouse().move(dx, dy, dv, dh);
+  Runtime.hid().mouse().sendReport();
 }
 
 // -----------------------------------------------------------------------------
@@ -295,14 +333,15 @@ uint8_t accelFactor(uint8_t accel_step) {
 }
 
 // -----------------------------------------------------------------------------
-// Compute the distance the mouse cursor should move in subpixels, return the
-// number of pixels the mouse should move (in active directions), and store the
-// remaining subpixels for the next move.
-uint8_t MouseKeys::cursorDelta() const {
+// Compute the distance the mouse cursor should move in subpixels over
+// `elapsed_time` milliseconds, return the number of pixels the mouse should
+// move (in active directions), and store the remaining subpixels for the next
+// move.
+uint8_t MouseKeys::cursorDelta(uint8_t elapsed_time) {
   // When the cursor speed is slow, it can be moving less than one pixel per
   // update, so we need to calculate movement in "subpixels" and store the
-  // remaining subpixels to add to the next update's movement.
-  static uint8_t subpixel_remainder{0};
+  // remaining subpixels (in `cursor_subpixels_`) to add to the next update's
+  // movement.
 
   // First, we calculate where we are on the "time" axis of the acceleration
   // curve, based on the time passed since the first cursor movement key was
@@ -337,52 +376,23 @@ uint8_t MouseKeys::cursorDelta() const {
   // compromise.
   subpixel_speed >>= 4;
 
-  // `max_speed` and `accel_factor` can both be up to 255.  So we can't
-  // just multiply by `cursor_update_interval_ without risk of overflow.  The
-  // update interval should be some low number, anyway (8 or less, I think), and
-  // should probably be fixed as a constexpr, so we could just leave it out.
-  subpixel_speed *= cursor_update_interval_;
-
-  // There's no risk of overflow here: (255 * 255) + 255 = 65535
-  subpixel_speed += subpixel_remainder;
-
-  // Set minimum speed
-  subpixel_speed += 64;
-
-  // This shift should be more than eight pixels; a single update of 100 pixels
-  // is a huge jump.  See above.
-  uint8_t pixel_speed = subpixel_speed >> 8;
-  // Truncate to get only lower 8 bits.
-  subpixel_remainder = subpixel_speed;
-  //subpixel_remainder = subpixel_speed - (uint16_t(pixel_speed) << 8);
-  return pixel_speed;
-}
-
-// -----------------------------------------------------------------------------
-// Wheel speed should be controlled by changing the update interval, not by
-// setting `wheel_speed_`.
-void MouseKeys::sendMouseWheelReport() const {
-  int8_t dh = 0;
-  int8_t dv = 0;
-
-  uint8_t direction = directions_ >> wheel_offset_;
-
-  if (direction != 0) {
-    // Horizontal scroll wheel:
-    if (direction & KEY_MOUSE_LEFT)
-      dh -= 1;
-    if (direction & KEY_MOUSE_RIGHT)
-      dh += 1;
-    // Vertical scroll wheel (note coordinates are opposite movement):
-    if (direction & KEY_MOUSE_UP)
-      dv += 1;
-    if (direction & KEY_MOUSE_DOWN)
-      dv -= 1;
-
-    // Send the report.
-    Runtime.hid().mouse().move(0, 0, dv, dh);
-    Runtime.hid().mouse().sendReport();
-  }
+  // Set minimum speed (in subpixels per millisecond)
+  subpixel_speed += 16;
+
+  // `max_speed` and `accel_factor` can both be up to 255, and the elapsed time
+  // is usually `cursor_update_interval_`, but can be longer when a cycle takes
+  // a while, so the distance is computed in 32 bits.
+  uint32_t subpixels = uint32_t(subpixel_speed) * elapsed_time;
+  subpixels += cursor_subpixels_;
+
+  // Only the fraction of a pixel is kept for the next move. If the cursor has
+  // fallen so far behind that it would have to jump by more than a report can
+  // hold, the rest of the distance is dropped, rather than sent later.
+  uint32_t pixels   = subpixels >> 8;
+  cursor_subpixels_ = uint8_t(subpixels);
+  if (pixels > 127)
+    pixels = 127;
+  return uint8_t(pixels);
 }
 
 }  // namespace plugin
@@ -29,6 +29,7 @@
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
 
+#include "kaleidoscope/plugin/mousekeys/MouseKeyDefs.h"    // for IS_MOUSE_KEY
 #include "kaleidoscope/plugin/mousekeys/MouseWarpModes.h"  // for warp modes
 // =============================================================================
 // Deprecated MousKeys code
@@ -144,6 +145,9 @@ class MouseKeys : public kaleidoscope::Plugin {
   EventHandlerResult onSetup();
   EventHandlerResult onNameQuery();
   EventHandlerResult afterEachCycle();
+  // Both `onKeyEvent()` and `onAddToReport()` only act on mouse keys.
+  using KeyEventRange = KeyRange<(SYNTHETIC | IS_MOUSE_KEY) << 8,
+                                 ((SYNTHETIC | IS_MOUSE_KEY) << 8) | 0xff>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult onAddToReport(Key key);
   EventHandlerResult afterReportingState(const KeyEvent &event);
@@ -171,6 +175,7 @@ class MouseKeys : public kaleidoscope::Plugin {
   uint16_t cursor_start_time_      = 0;
   uint8_t last_cursor_update_time_ = 0;
   uint8_t last_wheel_update_time_  = 0;
+  uint8_t cursor_subpixels_        = 0;
 
   // Mouse cursor and wheel movement directions are stored in a single bitfield
   // to save space.  The low four bits are for cursor movement, and the high
@@ -191,11 +196,10 @@ class MouseKeys : public kaleidoscope::Plugin {
 
   void sendMouseButtonReport() const;
   void sendMouseWarpReport(const KeyEvent &event) const;
-  void sendMouseMoveReport() const;
-  void sendMouseWheelReport() const;
+  void sendMouseMoveReport(uint8_t cursor_time, uint8_t wheel_steps);
 
   uint8_t accelStep() const;
-  uint8_t cursorDelta() const;
+  uint8_t cursorDelta(uint8_t elapsed_time);
 };
 
 // =============================================================================
@@ -315,6 +315,10 @@ EventHandlerResult OneShot::afterEachCycle() {
   // timeout, it's safe to advance the timer to the current time.
   if (!any_temp_keys) {
     start_time_ = Runtime.millisAtCycleStart();
+  } else {
+    // Don't let tickless idle mode sleep past the timeout.
+    uint16_t elapsed_time = Runtime.millisAtCycleStart() - start_time_;
+    Runtime.limitIdleTime(elapsed_time < settings_.timeout ? settings_.timeout - elapsed_time : 0);
   }
 
   return EventHandlerResult::OK;
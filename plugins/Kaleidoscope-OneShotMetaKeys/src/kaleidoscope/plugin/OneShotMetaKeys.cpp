@@ -58,7 +58,7 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
     // Note: we don't need to explicitly skip the key the active sticky key
     // itself (i.e. `event.addr`), because its entry in `live_keys[]` has not
     // yet been inserted at this point.
-    for (KeyAddr addr : KeyAddr::all()) {
+    for (KeyAddr addr : live_keys.activeKeys()) {
       // Get the entry from the keyboard state array.
       Key key = live_keys[addr];
       // Skip idle and masked entries.
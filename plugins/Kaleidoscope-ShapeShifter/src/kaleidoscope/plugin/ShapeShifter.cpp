@@ -57,7 +57,7 @@ EventHandlerResult ShapeShifter::onKeyEvent(KeyEvent &event) {
 
   bool shift_detected = false;
 
-  for (KeyAddr k : KeyAddr::all()) {
+  for (KeyAddr k : live_keys.activeKeys()) {
     if (live_keys[k].isKeyboardShift())
       shift_detected = true;
   }
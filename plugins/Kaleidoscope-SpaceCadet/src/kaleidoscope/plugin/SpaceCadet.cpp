@@ -144,6 +144,7 @@ EventHandlerResult SpaceCadet::onKeyswitchEvent(KeyEvent &event) {
       // Queue the press event and abort; this press event will be resolved
       // later.
       event_queue_.append(event);
+      updateTimeoutTimer();
       return EventHandlerResult::ABORT;
     }
   }
@@ -152,27 +153,40 @@ EventHandlerResult SpaceCadet::onKeyswitchEvent(KeyEvent &event) {
 }
 
 // -----------------------------------------------------------------------------
-EventHandlerResult SpaceCadet::afterEachCycle() {
+void SpaceCadet::onTimeout(void *context) {
+  SpaceCadet &plugin = *static_cast<SpaceCadet *>(context);
   // If there's no pending event, return.
-  if (event_queue_.isEmpty())
-    return EventHandlerResult::OK;
-
-  // Get timeout value for the pending key.
-  uint16_t pending_timeout = settings_.timeout;
-  if (map_[pending_map_index_].timeout != 0)
-    pending_timeout = map_[pending_map_index_].timeout;
-  uint16_t start_time = event_queue_.timestamp(0);
+  if (plugin.event_queue_.isEmpty())
+    return;
 
-  if (Runtime.hasTimeExpired(start_time, pending_timeout)) {
+  uint16_t start_time = plugin.event_queue_.timestamp(0);
+  if (Runtime.hasTimeExpired(start_time, plugin.pendingTimeout())) {
     // The timer has expired; release the pending event unchanged.
-    flushQueue();
+    plugin.flushQueue();
+  } else {
+    // The timeout was changed while the key was pending.
+    plugin.updateTimeoutTimer();
   }
-  return EventHandlerResult::OK;
 }
 
 // =============================================================================
 // Private helper function(s)
 
+// Get timeout value for the pending key.
+uint16_t SpaceCadet::pendingTimeout() const {
+  if (map_[pending_map_index_].timeout != 0)
+    return map_[pending_map_index_].timeout;
+  return settings_.timeout;
+}
+
+void SpaceCadet::updateTimeoutTimer() {
+  if (event_queue_.isEmpty()) {
+    timeout_timer_.cancel();
+  } else {
+    timeout_timer_.startAt(event_queue_.timestamp(0), pendingTimeout());
+  }
+}
+
 int8_t SpaceCadet::getSpaceCadetKeyIndex(Key key) const {
   for (uint8_t i = 0; !map_[i].isEmpty(); ++i) {
     if (map_[i].input == key) {
@@ -186,6 +200,7 @@ void SpaceCadet::flushQueue() {
   while (!event_queue_.isEmpty()) {
     flushEvent(false);
   }
+  timeout_timer_.cancel();
 }
 
 void SpaceCadet::flushEvent(bool is_tap) {
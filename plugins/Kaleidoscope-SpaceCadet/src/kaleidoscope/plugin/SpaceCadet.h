@@ -29,6 +29,7 @@
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -95,6 +96,7 @@ class SpaceCadet : public kaleidoscope::Plugin {
 
   void setTimeout(uint16_t timeout) {
     settings_.timeout = timeout;
+    updateTimeoutTimer();
   }
 
   uint16_t getTimeout() {
@@ -107,7 +109,6 @@ class SpaceCadet : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  protected:
   enum Mode : uint8_t {
@@ -140,6 +141,13 @@ class SpaceCadet : public kaleidoscope::Plugin {
   // index of that key in the array.
   int8_t pending_map_index_ = -1;
 
+  // Expires when the pending SpaceCadet key has been held for its timeout.
+  Timer timeout_timer_{&SpaceCadet::onTimeout, this};
+
+  static void onTimeout(void *context);
+  uint16_t pendingTimeout() const;
+  void updateTimeoutTimer();
+
   int8_t getSpaceCadetKeyIndex(Key key) const;
 
   void flushEvent(bool is_tap = false);
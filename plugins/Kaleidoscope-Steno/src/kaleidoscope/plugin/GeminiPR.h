@@ -32,6 +32,7 @@ namespace steno {
 class GeminiPR : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onNameQuery();
+  using KeyEventRange = KeyRange<ranges::STENO_FIRST, ranges::STENO_LAST>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
 
  private:
@@ -78,6 +78,28 @@ void TapDance::flushQueue(KeyAddr ignored_addr) {
     if (queued_event.addr != ignored_addr)
       Runtime.handleKeyswitchEvent(queued_event);
   }
+  timeout_timer_.cancel();
+}
+
+uint16_t TapDance::timeout() const {
+#ifndef NDEPRECATED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+  return time_out;
+#pragma GCC diagnostic pop
+#else
+  return timeout_;
+#endif
+}
+
+// Keep the timer in step with the TapDance key press at the head of the queue,
+// if any.
+void TapDance::updateTimeoutTimer() {
+  if (event_queue_.isEmpty()) {
+    timeout_timer_.cancel();
+  } else {
+    timeout_timer_.startAt(event_queue_.timestamp(0), timeout());
+  }
 }
 
 // --- hooks ---
@@ -135,53 +157,57 @@ EventHandlerResult TapDance::onKeyswitchEvent(KeyEvent &event) {
   flushQueue(event.addr);
   event_queue_.append(event);
   tapDanceAction(td_id, td_addr, ++tap_count_, Tap);
+  updateTimeoutTimer();
   return EventHandlerResult::ABORT;
 }
 
+#ifndef NDEPRECATED
+// Sketches can still assign to the deprecated `time_out` variable directly,
+// which the timer wouldn't notice, so we pick up the new value here.
 EventHandlerResult TapDance::afterEachCycle() {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+  if (time_out != timeout_)
+    setTimeout(time_out);
+#pragma GCC diagnostic pop
+  return EventHandlerResult::OK;
+}
+#endif
+
+void TapDance::onTimeout(void *context) {
+  TapDance &plugin = *static_cast<TapDance *>(context);
   // If there's no active TapDance sequence, there's nothing to do.
-  if (event_queue_.isEmpty())
-    return EventHandlerResult::OK;
+  if (plugin.event_queue_.isEmpty())
+    return;
 
   // The first event in the queue is now guaranteed to be a TapDance key.
-  KeyAddr td_addr = event_queue_.addr(0);
+  KeyAddr td_addr = plugin.event_queue_.addr(0);
   Key td_key      = Layer.lookupOnActiveLayer(td_addr);
   uint8_t td_id   = td_key.getRaw() - ranges::TD_FIRST;
 
-  // Check for timeout
-  uint16_t start_time = event_queue_.timestamp(0);
-  // To avoid confusing editors with unmatched braces, we use a temporary
-  // boolean, until the deprecated code can be removed.
-  bool timed_out = false;
-#ifndef NDEPRECATED
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time, time_out))
-    timed_out = true;
-#pragma GCC diagnostic pop
-#else
-  if (Runtime.hasTimeExpired(start_time, timeout_))
-    timed_out = true;
-#endif
-  if (timed_out) {
-    // We start with the assumption that the TapDance key is still being held.
-    ActionType action = Hold;
-    // Now we search for a release event for the TapDance key, starting from the
-    // second event in the queue (the first one being its press event).
-    for (uint8_t i{1}; i < event_queue_.length(); ++i) {
-      // It should be safe to assume that if we find a second event for the same
-      // address, it's a release, so we skip the test for it.
-      if (event_queue_.addr(i) == td_addr) {
-        action = Timeout;
-        // We don't need to bother breaking here because this is basically
-        // guaranteed to be the last event in the queue.
-      }
+  // Check for timeout; it might have been changed since the timer was started.
+  uint16_t start_time = plugin.event_queue_.timestamp(0);
+  if (!Runtime.hasTimeExpired(start_time, plugin.timeout())) {
+    plugin.updateTimeoutTimer();
+    return;
+  }
+
+  // We start with the assumption that the TapDance key is still being held.
+  ActionType action = Hold;
+  // Now we search for a release event for the TapDance key, starting from the
+  // second event in the queue (the first one being its press event).
+  for (uint8_t i{1}; i < plugin.event_queue_.length(); ++i) {
+    // It should be safe to assume that if we find a second event for the same
+    // address, it's a release, so we skip the test for it.
+    if (plugin.event_queue_.addr(i) == td_addr) {
+      action = Timeout;
+      // We don't need to bother breaking here because this is basically
+      // guaranteed to be the last event in the queue.
     }
-    tapDanceAction(td_id, td_addr, tap_count_, action);
-    flushQueue();
-    tap_count_ = 0;
   }
-  return EventHandlerResult::OK;
+  tapDanceAction(td_id, td_addr, plugin.tap_count_, action);
+  plugin.flushQueue();
+  plugin.tap_count_ = 0;
 }
 
 }  // namespace plugin
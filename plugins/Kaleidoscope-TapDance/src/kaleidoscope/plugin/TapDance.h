@@ -30,6 +30,7 @@
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Scheduler.h"             // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -80,13 +81,16 @@ class TapDance : public kaleidoscope::Plugin {
 #pragma GCC diagnostic pop
 #endif
     timeout_ = timeout;
+    updateTimeoutTimer();
   }
 
   void actionKeys(uint8_t tap_count, ActionType tap_dance_action, uint8_t max_keys, const Key tap_keys[]);
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
+#ifndef NDEPRECATED
   EventHandlerResult afterEachCycle();
+#endif
 
   static constexpr bool isTapDanceKey(Key key) {
     return (key.getRaw() >= ranges::TD_FIRST &&
@@ -108,6 +112,13 @@ class TapDance : public kaleidoscope::Plugin {
   // Time to wait for another input event before resolving a TapDance sequence.
   uint16_t timeout_ = 200;
 
+  // Expires when the current TapDance sequence has timed out.
+  Timer timeout_timer_{&TapDance::onTimeout, this};
+
+  static void onTimeout(void *context);
+  uint16_t timeout() const;
+  void updateTimeoutTimer();
+
   void flushQueue(KeyAddr ignored_addr = KeyAddr::none());
 };
 
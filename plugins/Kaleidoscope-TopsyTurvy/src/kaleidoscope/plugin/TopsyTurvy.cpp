@@ -61,7 +61,7 @@ EventHandlerResult TopsyTurvy::onKeyEvent(KeyEvent &event) {
   }
 
   if (tt_addr_.isValid()) {
-    for (KeyAddr key_addr : KeyAddr::all()) {
+    for (KeyAddr key_addr : live_keys.activeKeys()) {
       if (key_addr == event.addr)
         continue;
 
@@ -88,7 +88,7 @@ EventHandlerResult TopsyTurvy::beforeReportingState(const KeyEvent &event) {
   // guaranteed to be safe, anyway. Therefore, we assume that if `tt_addr` is
   // valid, it is also the last key pressed.
   bool shift_detected = false;
-  for (KeyAddr key_addr : KeyAddr::all()) {
+  for (KeyAddr key_addr : live_keys.activeKeys()) {
     if (live_keys[key_addr].isKeyboardShift()) {
       shift_detected = true;
       break;
@@ -145,7 +145,7 @@ EventHandlerResult Turbo::beforeSyncingLeds() {
       flash_start_time_ = Runtime.millisAtCycleStart();
       leds_on           = !leds_on;
     }
-    for (KeyAddr key_addr : KeyAddr::all()) {
+    for (KeyAddr key_addr : live_keys.activeKeys()) {
       Key key = live_keys[key_addr];
       if (key.isKeyboardKey()) {
         LEDControl::setCrgbAt(key_addr, color);
@@ -41,6 +41,10 @@ namespace kaleidoscope {
 // other data, in order to best serve the specific needs of the Qukeys
 // plugin. Its performance is better for a queue that needs to be searched much
 // more frequently than entries are added or removed.
+//
+// The entries are stored in a ring buffer, so removing entries from the head
+// of the queue (by far the most common case) takes constant time, regardless
+// of the queue's capacity.
 template<uint8_t _capacity,
          typename _Bitfield  = uint8_t,
          typename _Timestamp = uint16_t>
@@ -50,12 +54,26 @@ class KeyAddrEventQueue {
                 "EventQueue error: _Bitfield type too small for _capacity!");
 
  private:
+  uint8_t head_{0};
   uint8_t length_{0};
   KeyEventId event_ids_[_capacity];   // NOLINT(runtime/arrays)
   KeyAddr addrs_[_capacity];          // NOLINT(runtime/arrays)
   _Timestamp timestamps_[_capacity];  // NOLINT(runtime/arrays)
   _Bitfield release_event_bits_;
 
+  // Translate a queue index (counting from the head) into an array index.
+  uint8_t slot(uint8_t index) const {
+    uint8_t i = head_ + index;
+    return (i < _capacity) ? i : i - _capacity;
+  }
+
+  void copyEntry(uint8_t to_slot, uint8_t from_slot) {
+    event_ids_[to_slot]  = event_ids_[from_slot];
+    addrs_[to_slot]      = addrs_[from_slot];
+    timestamps_[to_slot] = timestamps_[from_slot];
+    bitWrite(release_event_bits_, to_slot, bitRead(release_event_bits_, from_slot));
+  }
+
  public:
   uint8_t length() const {
     return length_;
@@ -72,22 +90,22 @@ class KeyAddrEventQueue {
   // the queue, which will terminate when `index >= queue.length()`.
   KeyEventId id(uint8_t index) const {
     // assert(index < length_);
-    return event_ids_[index];
+    return event_ids_[slot(index)];
   }
 
   KeyAddr addr(uint8_t index) const {
     // assert(index < length_);
-    return addrs_[index];
+    return addrs_[slot(index)];
   }
 
   _Timestamp timestamp(uint8_t index) const {
     // assert(index < length_);
-    return timestamps_[index];
+    return timestamps_[slot(index)];
   }
 
   bool isRelease(uint8_t index) const {
     // assert(index < length_);
-    return bitRead(release_event_bits_, index);
+    return bitRead(release_event_bits_, slot(index));
   }
   bool isPress(uint8_t index) const {
     // assert(index < length_);
@@ -98,58 +116,49 @@ class KeyAddrEventQueue {
   // for bounds checking; we don't guard against it here.
   void append(const KeyEvent &event) {
     // assert(length_ < _capacity);
-    event_ids_[length_]  = event.id();
-    addrs_[length_]      = event.addr;
-    timestamps_[length_] = Runtime.millisAtCycleStart();
-    bitWrite(release_event_bits_, length_, keyToggledOff(event.state));
+    uint8_t tail = slot(length_);
+    event_ids_[tail]  = event.id();
+    addrs_[tail]      = event.addr;
+    timestamps_[tail] = Runtime.millisAtEvent(event);
+    bitWrite(release_event_bits_, tail, keyToggledOff(event.state));
     ++length_;
   }
 
-  // Remove an event from the head of the queue, shifting the subsequent
-  // ones. This function actually shifts the queue by copying element values,
-  // rather than using a ring buffer because we expect it will be called much
-  // less often than the queue is searched via a for loop.
+  // Remove an event from the queue. Removing the head of the queue only moves
+  // the head forward. Removing an entry from the middle closes the gap by
+  // moving the entries on whichever side of it is shorter.
   void remove(uint8_t n = 0) {
     if (n >= length_ || length_ == 0)
       return;
     // assert(length > n);
-    --length_;
-    for (uint8_t i{n}; i < length_; ++i) {
-      event_ids_[i]  = event_ids_[i + 1];
-      addrs_[i]      = addrs_[i + 1];
-      timestamps_[i] = timestamps_[i + 1];
+    if (n < length_ / 2) {
+      for (uint8_t i{n}; i > 0; --i)
+        copyEntry(slot(i), slot(i - 1));
+      head_ = slot(1);
+    } else {
+      for (uint8_t i{n}; i < length_ - 1; ++i)
+        copyEntry(slot(i), slot(i + 1));
     }
-    // mask = all ones for bits >= n, zeros otherwise
-    _Bitfield mask = _Bitfield(~0) << n;
-    // use the inverse mask to get just the low bits (that won't be shifted)
-    _Bitfield low_bits = release_event_bits_ & ~mask;
-    // shift the event bits
-    release_event_bits_ >>= 1;
-    // use the mask to zero the low bits, leaving only the shifted high bits
-    release_event_bits_ &= mask;
-    // add the low bits back in
-    release_event_bits_ |= low_bits;
+    --length_;
   }
 
   void shift() {
     remove(0);
   }
 
+  // Remove the first `n` events from the queue.
   void shift(uint8_t n) {
     if (n >= length_) {
       clear();
       return;
     }
+    head_ = slot(n);
     length_ -= n;
-    for (uint8_t i{0}; i < length_; ++i) {
-      addrs_[i]      = addrs_[i + n];
-      timestamps_[i] = timestamps_[i + n];
-    }
-    release_event_bits_ >>= n;
   }
 
   // Empty the queue entirely.
   void clear() {
+    head_               = 0;
     length_             = 0;
     release_event_bits_ = 0;
   }
@@ -167,7 +176,7 @@ class KeyAddrEventQueue {
     // The compiler doesn't let us preserve the type of our integers here, so we
     // need to convert the difference back to int8_t to avoid a bug when it
     // overflows and the new event id is negative, but the old id is positive.
-    KeyEventId offset = event.id() - event_ids_[0];
+    KeyEventId offset = event.id() - id(0);
     // If the offset is negative, the event being processed is older than the
     // first event in the queue.  This shouldn't happen because the caller
     // should first check `KeyEventTracker::shouldIgnore()`, and only call this
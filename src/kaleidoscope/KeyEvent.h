@@ -22,11 +22,24 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t, int8_t
+#include <stdint.h>  // for uint8_t, int8_t, uint32_t
 
 #include "kaleidoscope/KeyAddr.h"   // for KeyAddr
 #include "kaleidoscope/key_defs.h"  // for Key_Undefined, Key
 
+// Whether key events carry the time at which the key scanner detected them
+// (see `KeyEvent::timestamp()`). That takes four more bytes per event, so it is
+// off by default on AVR, where the key scanners don't record it anyway. When
+// it's off, every event counts as having happened at the start of the cycle
+// in which it was handled.
+#ifndef KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS
+#ifdef __AVR__
+#define KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS 0
+#else
+#define KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS 1
+#endif
+#endif
+
 namespace kaleidoscope {
 
 // It's important that this is a signed integer, not unsigned.
@@ -44,8 +57,10 @@ struct KeyEvent {
 
   // For use by keyscanner creating a new event from a physical keyswitch toggle
   // on or off.
-  static KeyEvent next(KeyAddr addr, uint8_t state) {
-    return KeyEvent(addr, state, Key_Undefined, ++last_id_);
+  static KeyEvent next(KeyAddr addr, uint8_t state, uint32_t timestamp = 0) {
+    KeyEvent event(addr, state, Key_Undefined, ++last_id_);
+    event.setTimestamp(timestamp);
+    return event;
   }
 
   KeyEventId id() const {
@@ -57,6 +72,25 @@ struct KeyEvent {
     other.id_         = tmp_id;
   }
 
+  // The time (from `micros()`) at which the key scanner detected the keyswitch
+  // toggling on or off, if it can tell. Zero means it's unknown, which is the
+  // case for events that don't come directly from a key scanner, and for all
+  // events if `KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS` is off. See
+  // `Runtime.millisAtEvent()`.
+#if KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS
+  uint32_t timestamp() const {
+    return timestamp_;
+  }
+  void setTimestamp(uint32_t timestamp) {
+    timestamp_ = timestamp;
+  }
+#else
+  uint32_t timestamp() const {
+    return 0;
+  }
+  void setTimestamp(uint32_t) {}
+#endif
+
   KeyAddr addr  = KeyAddr::none();
   uint8_t state = 0;
   Key key       = Key_Undefined;
@@ -65,6 +99,9 @@ struct KeyEvent {
   // serial number of the event:
   static KeyEventId last_id_;
   KeyEventId id_;
+#if KALEIDOSCOPE_KEY_EVENT_TIMESTAMPS
+  uint32_t timestamp_ = 0;
+#endif
 };
 
 }  // namespace kaleidoscope
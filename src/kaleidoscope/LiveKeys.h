@@ -22,8 +22,9 @@
 
 #pragma once
 
-#include "kaleidoscope/KeyAddr.h"     // for KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"  // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"  // for KeyAddrBitfield
+#include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
 #include "kaleidoscope/KeyMap.h"      // for KeyMap
 #include "kaleidoscope/key_defs.h"    // for Key, Key_Masked, Key_Inactive
 
@@ -47,6 +48,14 @@ namespace kaleidoscope {
 /// engaged), and the `Key` value is what the that key is "sending" at the
 /// time. At the end of its processing of a `KeyEvent`, Kaleidoscope will use
 /// the contents of this array to populate the Keyboard HID reports.
+///
+/// Alongside the array, a bitfield of "active" entries is maintained, so that
+/// the HID report can be built by visiting only the keys that might contribute
+/// to it. A bit that is clear guarantees that the corresponding entry is
+/// `Key_Inactive`; a bit that is set only means that the entry *might* be
+/// active, because writes made through the non-const subscript operator can't
+/// be tracked precisely. Such stale bits get dropped the next time the active
+/// entries are visited.
 
 class LiveKeys {
  public:
@@ -60,9 +69,11 @@ class LiveKeys {
   }
 
   // For array-style subscript addressing of entries by reference. The client
-  // code can alter values in the array this way.
+  // code can alter values in the array this way, so the entry has to be
+  // treated as (possibly) active from now on.
   Key &operator[](KeyAddr key_addr) {
     if (key_addr.isValid()) {
+      active_keys_.set(key_addr);
       return key_map_[key_addr];
     }
     dummy_ = Key_Masked;
@@ -71,21 +82,27 @@ class LiveKeys {
 
   /// Set an entry to "active" with a specified `Key` value.
   void activate(KeyAddr key_addr, Key key) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = key;
+      active_keys_.write(key_addr, key != Key_Inactive);
+    }
   }
 
   /// Deactivate an entry by setting its value to `Key_Inactive`.
   void clear(KeyAddr key_addr) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = Key_Inactive;
+      active_keys_.clear(key_addr);
+    }
   }
 
   /// Mask a key by setting its entry to `Key_Masked`. The key will become
   /// unmasked by Kaleidoscope on release (but not on a key press event).
   void mask(KeyAddr key_addr) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = Key_Masked;
+      active_keys_.set(key_addr);
+    }
   }
 
   /// Clear the entire array by setting all values to `Key_Inactive`.
@@ -93,17 +110,33 @@ class LiveKeys {
     for (Key &key : key_map_) {
       key = Key_Inactive;
     }
+    active_keys_.clear();
   }
 
   /// Returns an iterator for use in range-based for loops:
   ///
   ///   for (Key key : live_keys.all()) {...}
+  ///
+  /// This is meant for read access; entries changed through it will not be
+  /// tracked by the `activeKeys()` bitfield.
   KeyMap &all() {
     return key_map_;
   }
 
+  /// Returns the bitfield of (possibly) active entries, for use in range-based
+  /// for loops that only need to visit keys that aren't `Key_Inactive`:
+  ///
+  ///   for (KeyAddr key_addr : live_keys.activeKeys()) {...}
+  ///
+  /// It is safe to call `clear(key_addr)` on the current entry from inside such
+  /// a loop.
+  const KeyAddrBitfield &activeKeys() const {
+    return active_keys_;
+  }
+
  private:
   KeyMap key_map_;
+  KeyAddrBitfield active_keys_;
   mutable Key dummy_{0, 0};
 };
 
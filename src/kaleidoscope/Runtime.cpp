@@ -22,21 +22,38 @@
 
 #include "kaleidoscope/Runtime.h"
 
-#include <Arduino.h>         // for millis
+#include <Arduino.h>         // for millis, micros
 #include <HardwareSerial.h>  // for HardwareSerial
 
 #include "kaleidoscope/KeyAddr.h"                   // for KeyAddr, MatrixAddr, MatrixAddr...
 #include "kaleidoscope/KeyEvent.h"                  // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"                  // for LiveKeys, live_keys
+#include "kaleidoscope/Scheduler.h"                 // for Scheduler
 #include "kaleidoscope/device/device.h"             // for Base<>::HID, VirtualProps::HID
 #include "kaleidoscope/driver/hid/base/Keyboard.h"  // for Keyboard
 #include "kaleidoscope/keyswitch_state.h"           // for keyToggledOff, keyToggledOn
+#include "kaleidoscope/latency_histogram.h"         // for recordEvent
 #include "kaleidoscope/layers.h"                    // for Layer, Layer_
 
 namespace kaleidoscope {
 
 uint32_t Runtime_::millis_at_cycle_start_;
-KeyAddr Runtime_::last_addr_toggled_on_ = KeyAddr::none();
+uint32_t Runtime_::micros_at_cycle_start_;
+KeyAddr Runtime_::last_addr_toggled_on_           = KeyAddr::none();
+uint16_t Runtime_::max_idle_time_                 = 0;
+uint32_t Runtime_::idle_time_limit_               = Scheduler::no_deadline;
+bool Runtime_::report_batch_open_                 = false;
+Runtime_::PendingReport Runtime_::pending_report_ = PendingReport::None;
+KeyEvent Runtime_::batched_events_[Runtime_::max_batched_events_];
+uint8_t Runtime_::batched_event_count_ = 0;
+
+// Only the reports of events that press or release a plain keyboard key (with
+// no modifier flags) can be held back in a report batch.
+static bool isBatchable(const KeyEvent &event) {
+  return event.key.isKeyboardKey() &&
+         event.key.getFlags() == 0 &&
+         (keyToggledOn(event.state) || keyToggledOff(event.state));
+}
 
 static void onUSBReset();
 
@@ -73,6 +90,7 @@ void Runtime_::setup(void) {
 // ----------------------------------------------------------------------------
 void Runtime_::loop(void) {
   millis_at_cycle_start_ = millis();
+  micros_at_cycle_start_ = micros();
 
   if (device().pollUSBReset()) {
     device().hid().onUSBReset();
@@ -89,11 +107,48 @@ void Runtime_::loop(void) {
   // event is being handled at a time.
   device().scanMatrix();
 
+  // Any plugin timers that have expired get their callbacks called here, right
+  // before the `afterEachCycle()` hooks, where plugins used to check them.
+  Scheduler::runExpiredTimers();
 
   kaleidoscope::Hooks::afterEachCycle();
 
+  // Give HID drivers that queue their reports a chance to send them
+  device().hid().betweenCycles();
+
   // Let the device handle power management between cycles
   device().betweenCycles();
+
+  if (max_idle_time_ > 0)
+    idle();
+  idle_time_limit_ = Scheduler::no_deadline;
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::idle() {
+  // While keys are held, plugins may need to act on every cycle (MouseKeys,
+  // for example), so we only sleep when the keyboard is at rest.
+  if (device().pressedKeyswitchCount() > 0)
+    return;
+
+  // Reports the host wasn't ready for are only sent between cycles, and a
+  // key release left waiting would look like a stuck key.
+  if (device().hid().hasQueuedReports())
+    return;
+
+  uint32_t idle_time = Scheduler::millisUntilNextDeadline();
+  if (idle_time > idle_time_limit_)
+    idle_time = idle_time_limit_;
+  if (idle_time > max_idle_time_)
+    idle_time = max_idle_time_;
+
+  // The deadline is relative to the start of the cycle, so we subtract the
+  // time the cycle itself took.
+  uint32_t elapsed_time = millis() - millis_at_cycle_start_;
+  if (elapsed_time >= idle_time)
+    return;
+
+  device().idle(idle_time - elapsed_time);
 }
 
 // ----------------------------------------------------------------------------
@@ -150,6 +205,11 @@ void Runtime_::handleKeyEvent(KeyEvent event) {
     }
   }
 
+  // If a keyboard report is being held back, and this event can't be merged
+  // into it, send it now, before plugins (or the HID report) see the event.
+  if (pending_report_ != PendingReport::None && !canJoinReportBatch(event))
+    flushReportBatch();
+
   // If any `onKeyEvent()` handler returns `ABORT`, we return before updating
   // the Live Keys state array; as if the event didn't happen.
   auto result = Hooks::onKeyEvent(event);
@@ -197,6 +257,12 @@ void Runtime_::handleKeyEvent(KeyEvent event) {
     return;
   }
 
+  // The `onKeyEvent()` handlers may have changed the event's `Key` value (to a
+  // modifier, for example), so before the held back report gets rebuilt, we
+  // check again whether the event can still be merged into it.
+  if (pending_report_ != PendingReport::None && !canJoinReportBatch(event))
+    flushReportBatch();
+
   // Until this point, the old report was still valid. Now we construct the new
   // one, based on the contents of the `live_keys` state array.
   prepareKeyboardReport(event);
@@ -215,13 +281,13 @@ void Runtime_::prepareKeyboardReport(const KeyEvent &event) {
   // before building the new report, start clean
   device().hid().keyboard().releaseAllKeys();
 
-  // Build report from composite keymap cache. This can be much more efficient
-  // with a bitfield. What we should be doing here is going through the array
-  // and checking for HID values (Keyboard, Consumer, System) and directly
-  // adding them to their respective reports. This comes before the old plugin
-  // hooks are called for the new event so that the report will be full complete
-  // except for that new event.
-  for (KeyAddr key_addr : KeyAddr::all()) {
+  // Build report from the live keys state array, visiting only the entries
+  // that are flagged in its active keys bitfield. We're not checking the
+  // keycodes of the remaining entries, because they are all guaranteed to be
+  // `Key_Inactive`. This comes before the old plugin hooks are called for the
+  // new event so that the report will be full complete except for that new
+  // event.
+  for (KeyAddr key_addr : live_keys.activeKeys()) {
     // Skip this event's key addr; we will deal with that later. This is most
     // important in the case of a key release, because we can't safely remove
     // any keycode(s) added to the report later.
@@ -230,8 +296,16 @@ void Runtime_::prepareKeyboardReport(const KeyEvent &event) {
 
     Key key = live_keys[key_addr];
 
-    // If the key is idle or masked, we can ignore it.
-    if (key == Key_Inactive || key == Key_Masked)
+    // The bitfield can have stale bits set for entries that were written
+    // through `live_keys[]` and later became idle again. Drop those, so that
+    // subsequent reports don't need to look at them.
+    if (key == Key_Inactive) {
+      live_keys.clear(key_addr);
+      continue;
+    }
+
+    // If the key is masked, we can ignore it.
+    if (key == Key_Masked)
       continue;
 
     addToReport(key);
@@ -297,7 +371,8 @@ void Runtime_::sendKeyboardReport(const KeyEvent &event) {
     }
   } else if (event.addr != last_addr_toggled_on_) {
     // (not a keyboard key OR toggled off) AND not last keyboard key toggled on
-    Key last_key = live_keys[last_addr_toggled_on_];
+    const LiveKeys &keys = live_keys;
+    Key last_key         = keys[last_addr_toggled_on_];
     if (last_key.isKeyboardKey()) {
       hid().keyboard().pressModifiers(last_key);
     }
@@ -310,8 +385,50 @@ void Runtime_::sendKeyboardReport(const KeyEvent &event) {
   if (Hooks::beforeReportingState(event) == EventHandlerResult::ABORT)
     return;
 
+  // Within a report batch, plain keyboard keys leave the report to be sent
+  // together with those of the following events. `handleKeyEvent()` has made
+  // sure that there's room for this one.
+  if (report_batch_open_ && isBatchable(event)) {
+    batched_events_[batched_event_count_++] = event;
+    pending_report_ = keyToggledOn(event.state) ? PendingReport::Press : PendingReport::Release;
+    return;
+  }
+
   // Finally, send the report:
   device().hid().keyboard().sendReport();
+
+  latency_histogram::recordEvent(event);
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::endReportBatch() {
+  if (pending_report_ != PendingReport::None)
+    flushReportBatch();
+  report_batch_open_ = false;
+}
+
+bool Runtime_::canJoinReportBatch(const KeyEvent &event) {
+  if (!isBatchable(event) || batched_event_count_ == max_batched_events_)
+    return false;
+
+  if (keyToggledOn(event.state)) {
+    // A modifier pressed after another key would apply to that key, too, and
+    // the host has to see a keycode released before it's pressed again.
+    return pending_report_ == PendingReport::Press &&
+           !event.key.isKeyboardModifier() &&
+           !hid().keyboard().isKeyPressed(event.key);
+  }
+
+  return pending_report_ == PendingReport::Release;
+}
+
+void Runtime_::flushReportBatch() {
+  device().hid().keyboard().sendReport();
+  pending_report_ = PendingReport::None;
+
+  for (uint8_t i = 0; i < batched_event_count_; i++)
+    latency_histogram::recordEvent(batched_events_[i]);
+  batched_event_count_ = 0;
 }
 
 Runtime_ Runtime;
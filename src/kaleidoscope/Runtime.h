@@ -106,6 +106,63 @@ class Runtime_ {
     return millis_at_cycle_start_;
   }
 
+  /** Returns the value of `micros()` at the start of the cycle.
+   */
+  static uint32_t microsAtCycleStart() {
+    return micros_at_cycle_start_;
+  }
+
+  /** Returns the time at which a keyswitch event happened.
+   *
+   * Key scanners that can tell when they detected a keyswitch state change
+   * (rather than when the event got handled) record it in the event (see `KeyEvent::timestamp()`).
+   * This converts that to milliseconds on the same clock as
+   * `millisAtCycleStart()`, so that it can be used as the `start_time` for
+   * `hasTimeExpired()`. Events without a timestamp, or with one after the
+   * start of the current cycle, are treated as having happened at the start
+   * of the cycle, which is also what all events used to get.
+   */
+  static uint32_t millisAtEvent(const KeyEvent &event) {
+    uint32_t timestamp = event.timestamp();
+    uint32_t age       = micros_at_cycle_start_ - timestamp;
+    if (timestamp == 0 || int32_t(age) <= 0)
+      return millis_at_cycle_start_;
+    return millis_at_cycle_start_ - age / 1000;
+  }
+
+  /** Tickless idle mode.
+   *
+   * By default, `loop()` starts the next cycle as soon as the previous one has
+   * finished. With a non-zero maximum idle time, when no keyswitches are
+   * pressed, the device sleeps between cycles instead, until the key scanner
+   * has something to do, or the next `Timer` is due, but no longer than
+   * `max_idle_time` milliseconds, or the time a plugin asked for with
+   * `limitIdleTime()`.
+   *
+   * This only has an effect on devices whose key scanner can tell when a scan
+   * is due; on others, the keyboard never sleeps between cycles.
+   */
+  static void setMaxIdleTime(uint16_t max_idle_time) {
+    max_idle_time_ = max_idle_time;
+  }
+  static uint16_t maxIdleTime() {
+    return max_idle_time_;
+  }
+
+  /** Keep tickless idle mode from sleeping past pending work
+   *
+   * Plugins that wait for something in `afterEachCycle()` (a timeout, or the
+   * next frame of an LED effect) instead of with a `Timer` call this from
+   * there, with the number of milliseconds until it's due, so that the device
+   * wakes up in time for it. With `0`, the device doesn't sleep at all. The
+   * limit only applies to the current cycle, so it has to be set again in
+   * each cycle for as long as the plugin is waiting.
+   */
+  static void limitIdleTime(uint32_t idle_time) {
+    if (idle_time < idle_time_limit_)
+      idle_time_limit_ = idle_time;
+  }
+
   /** Determines if a timer has expired.
    *
    * This method should be used whenever checking to see if a timeout has been
@@ -201,14 +258,38 @@ class Runtime_ {
    */
   void sendKeyboardReport(const KeyEvent &event);
 
+  /** Coalesce the keyboard reports of a batch of events
+   *
+   * Key scanners that deliver several keyswitch events at once (such as a
+   * chord, or a palm on the keyboard, found in a single scan) can handle them
+   * between `beginReportBatch()` and `endReportBatch()`. Within the batch, the
+   * keyboard report for an event that presses or releases a plain keyboard key
+   * is held back, and sent together with those of the following events, as
+   * long as the host can't tell the difference: events are only merged if they
+   * all press keys, or all release them, don't press a modifier after another
+   * key, and don't press a keycode that's already in the report. Any other
+   * event sends the held back report first, so the host sees the same
+   * sequence of key states as without batching, minus the intermediate steps
+   * of a chord. Plugin hooks, `afterReportingState()` included, still get
+   * called for every event, as it's handled. If they handle an event of their
+   * own (like OneShot releasing a modifier), that event is subject to the same
+   * rules, so a held back report is sent before one it can't be merged with.
+   */
+  static void beginReportBatch() {
+    report_batch_open_ = true;
+  }
+  void endReportBatch();
+
   /** Get the current value of a keymap entry
    *
    * Returns the `Key` value for a given `KeyAddr` entry in the current keymap,
    * overridden by any active entry in the `live_keys` array.
    */
   Key lookupKey(KeyAddr key_addr) {
-    // First, check for an active key value in the `live_keys` array.
-    Key key = live_keys[key_addr];
+    // First, check for an active key value in the `live_keys` array. This is a
+    // read-only access, so it mustn't flag the entry as (possibly) active.
+    const LiveKeys &keys = live_keys;
+    Key key              = keys[key_addr];
     // If that entry is clear, look up the entry from the active keymap layers.
     if (key == Key_Transparent) {
       key = Layer.lookupOnActiveLayer(key_addr);
@@ -230,7 +311,27 @@ class Runtime_ {
 
  private:
   static uint32_t millis_at_cycle_start_;
+  static uint32_t micros_at_cycle_start_;
   static KeyAddr last_addr_toggled_on_;
+  static uint16_t max_idle_time_;
+  static uint32_t idle_time_limit_;
+
+  enum class PendingReport : uint8_t {
+    None,
+    Press,
+    Release,
+  };
+  static bool report_batch_open_;
+  static PendingReport pending_report_;
+  // The events whose report is being held back. Their latency is recorded
+  // once it has been sent.
+  static constexpr uint8_t max_batched_events_ = 6;
+  static KeyEvent batched_events_[max_batched_events_];
+  static uint8_t batched_event_count_;
+
+  void idle();
+  bool canJoinReportBatch(const KeyEvent &event);
+  void flushReportBatch();
 };
 
 extern kaleidoscope::Runtime_ Runtime;
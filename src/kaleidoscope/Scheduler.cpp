@@ -0,0 +1,109 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/Scheduler.h"
+
+#include <stdint.h>  // for uint32_t, int32_t
+
+#include "kaleidoscope/Runtime.h"  // for Runtime_
+
+namespace kaleidoscope {
+
+constexpr uint32_t Scheduler::no_deadline;
+
+Timer *Scheduler::head_    = nullptr;
+Timer *Scheduler::expired_ = nullptr;
+
+// -----------------------------------------------------------------------------
+void Timer::start(uint32_t ttl) {
+  if (active_)
+    Scheduler::remove(*this);
+  deadline_ = Runtime_::millisAtCycleStart() + ttl;
+  Scheduler::insert(*this);
+}
+
+void Timer::cancel() {
+  if (active_)
+    Scheduler::remove(*this);
+}
+
+// -----------------------------------------------------------------------------
+void Scheduler::insert(Timer &timer) {
+  // Timers with the same deadline run in the order they were started.
+  Timer **link = &head_;
+  while (*link != nullptr &&
+         int32_t((*link)->deadline_ - timer.deadline_) <= 0)
+    link = &(*link)->next_;
+  timer.next_   = *link;
+  *link         = &timer;
+  timer.active_ = true;
+}
+
+void Scheduler::remove(Timer &timer) {
+  if (!unlink(head_, timer))
+    unlink(expired_, timer);
+  timer.next_   = nullptr;
+  timer.active_ = false;
+}
+
+bool Scheduler::unlink(Timer *&list, Timer &timer) {
+  for (Timer **link = &list; *link != nullptr; link = &(*link)->next_) {
+    if (*link == &timer) {
+      *link = timer.next_;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t Scheduler::millisUntilNextDeadline() {
+  if (head_ == nullptr)
+    return no_deadline;
+  if (hasExpired(*head_))
+    return 0;
+  return head_->deadline_ - Runtime_::millisAtCycleStart();
+}
+
+void Scheduler::runExpiredTimers() {
+  // First, move all the expired timers to a separate list, so that any timers
+  // (re)started by the callbacks don't get run in this pass. Timers on that
+  // list are still active until their callbacks are called, so they can be
+  // cancelled or restarted by earlier callbacks.
+  Timer **tail = &expired_;
+  while (head_ != nullptr && hasExpired(*head_)) {
+    Timer *timer = head_;
+    head_        = timer->next_;
+    timer->next_ = nullptr;
+    *tail        = timer;
+    tail         = &timer->next_;
+  }
+
+  while (expired_ != nullptr) {
+    Timer *timer   = expired_;
+    expired_       = timer->next_;
+    timer->next_   = nullptr;
+    timer->active_ = false;
+    timer->callback_(timer->context_);
+  }
+}
+
+}  // namespace kaleidoscope
@@ -0,0 +1,123 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t
+
+#include "kaleidoscope/Runtime.h"  // for Runtime_
+
+namespace kaleidoscope {
+
+/// A deadline that a plugin can register with the `Scheduler`
+///
+/// Instead of checking `Runtime.hasTimeExpired()` in every cycle, a plugin can
+/// start a `Timer` when it begins waiting for something, and have the timer's
+/// callback called once that time has come. Expired timers are run once per
+/// cycle, after the keyswitches have been scanned and before the
+/// `afterEachCycle()` hooks are called, so a callback is called in the same
+/// place where an `afterEachCycle()` handler would have noticed the timeout.
+///
+/// A `Timer` is meant to be a member of the plugin that uses it, and it must
+/// outlive its use; the scheduler keeps a pointer to each active timer.
+class Timer {
+ public:
+  typedef void (*Callback)(void *context);
+
+  constexpr Timer(Callback callback, void *context = nullptr)
+    : callback_(callback), context_(context) {}
+
+  /// Start (or restart) the timer, to expire `ttl` milliseconds after the
+  /// start of the current cycle. This corresponds to
+  /// `Runtime.hasTimeExpired(Runtime.millisAtCycleStart(), ttl)`.
+  void start(uint32_t ttl);
+
+  /// Start (or restart) the timer, to expire in the first cycle in which
+  /// `Runtime.hasTimeExpired(start_time, ttl)` would return `true`. The
+  /// arguments follow the same rules as those of `hasTimeExpired()`, so
+  /// plugins can pass the same timestamps and timeouts that they used to
+  /// check on every cycle.
+  template<typename _Timestamp, typename _Timeout>
+  void startAt(_Timestamp start_time, _Timeout ttl) {
+    _Timestamp elapsed_time = _Timestamp(Runtime_::millisAtCycleStart()) - start_time;
+    start(elapsed_time >= ttl ? 0 : ttl - elapsed_time);
+  }
+
+  /// Stop the timer, without calling its callback.
+  void cancel();
+
+  bool isActive() const {
+    return active_;
+  }
+
+ private:
+  friend class Scheduler;
+
+  Callback callback_;
+  void *context_;
+  uint32_t deadline_ = 0;
+  Timer *next_       = nullptr;
+  bool active_       = false;
+};
+
+/// The central timer service
+///
+/// Active timers are kept in a singly linked list, sorted by deadline, so that
+/// the next deadline can be found without looking at every timer. The list
+/// lives in the `Timer` objects themselves, so there is no fixed limit on the
+/// number of timers, and no memory is used for inactive ones.
+class Scheduler {
+ public:
+  static constexpr uint32_t no_deadline = UINT32_MAX;
+
+  /// Returns the number of milliseconds from the start of the current cycle
+  /// until the next timer expires, `0` if a timer has already expired, or
+  /// `no_deadline` if there are no active timers.
+  static uint32_t millisUntilNextDeadline();
+
+  static bool hasActiveTimers() {
+    return head_ != nullptr;
+  }
+
+ private:
+  friend class Runtime_;
+  friend class Timer;
+
+  static Timer *head_;
+  static Timer *expired_;
+
+  static void insert(Timer &timer);
+  static void remove(Timer &timer);
+  static bool unlink(Timer *&list, Timer &timer);
+
+  // Called by `Runtime` once per cycle, to call the callbacks of all timers
+  // that have expired by the start of the cycle. Timers that get started by
+  // those callbacks will not be run before the next cycle, even if they have
+  // already expired.
+  static void runExpiredTimers();
+
+  static bool hasExpired(const Timer &timer) {
+    return int32_t(Runtime_::millisAtCycleStart() - timer.deadline_) >= 0;
+  }
+};
+
+}  // namespace kaleidoscope
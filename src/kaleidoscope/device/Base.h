@@ -29,8 +29,9 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t, int8_t, uint32_t
-#include <string.h>  // for size_t, strlen, memcpy
+#include <Arduino.h>  // for millis
+#include <stdint.h>   // for uint8_t, int8_t, uint32_t
+#include <string.h>   // for size_t, strlen, memcpy
 
 #include "kaleidoscope/driver/bootloader/None.h"  // for None
 #include "kaleidoscope/driver/hid/Base.h"         // for Base, BaseProps
@@ -362,6 +363,18 @@ class Base {
   void actOnMatrixScan(void) {
     key_scanner_.actOnMatrixScan();
   }
+  /**
+   * Wait until the key scanner has something to do, or `timeout`
+   * milliseconds have passed, whichever comes first.
+   *
+   * While waiting, the MCU is put to sleep until the next interrupt. Devices
+   * whose key scanner can't tell when a scan is due return immediately.
+   */
+  void idle(uint32_t timeout) {
+    uint32_t start_time = millis();
+    while (!key_scanner_.scanPending() && millis() - start_time < timeout)
+      mcu_.waitForInterrupt();
+  }
   /** @} */
 
   /** @defgroup kaleidoscope_hardware_reattach Kaleidoscope::Hardware/Attach & Detach
@@ -38,6 +38,7 @@
 
 // From Kaleidoscope:
 #include "kaleidoscope/KeyAddr.h"                                  // for MatrixAddr, MatrixAddr...
+#include "kaleidoscope/Runtime.h"                                  // for Runtime, Runtime_
 #include "kaleidoscope/device/virtual/DefaultHIDReportConsumer.h"  // for DefaultHIDReportConsumer
 #include "kaleidoscope/device/virtual/Logging.h"                   // for log_error, logging
 #include "kaleidoscope/key_defs.h"                                 // for Key_NoKey
@@ -81,6 +82,7 @@ void VirtualKeyScanner::setup() {
   for (auto key_addr : KeyAddr::all()) {
     keystates_[key_addr.toInt()]      = KeyState::NotPressed;
     keystates_prev_[key_addr.toInt()] = KeyState::NotPressed;
+    timestamps_[key_addr.toInt()]     = 0;
   }
 }
 
@@ -231,6 +233,38 @@ void VirtualKeyScanner::readMatrix() {
 }
 void VirtualKeyScanner::actOnMatrixScan() {
 
+  // The virtual `millis()` advances with every call, so the idle timeout is
+  // measured with the start time of the cycle instead.
+  if (idle_tracker_.isIdle()) {
+    // As on real hardware, all rows are driven while idle, so the only thing
+    // to check is whether any key is down.
+    if (!anyKeyswitchDown())
+      return;
+    idle_tracker_.wake(Runtime.millisAtCycleStart());
+  }
+
+  if (scan_rate_.isAdaptive() &&
+      Runtime.microsAtCycleStart() - last_scan_micros_ < scan_rate_.interval())
+    return;
+  last_scan_micros_ = Runtime.microsAtCycleStart();
+  bool changing     = anyKeyswitchChanging();
+
+  if (event_batching_)
+    beginEventBatch();
+  if (scansRowStates()) {
+    actOnDebouncedMatrixScan();
+  } else {
+    actOnRawMatrixScan();
+  }
+  if (event_batching_)
+    endEventBatch();
+
+  scan_rate_.update(changing, Runtime.millisAtCycleStart());
+  idle_tracker_.update(n_pressed_switches_ == 0 && !anyKeyswitchDown(), Runtime.millisAtCycleStart());
+}
+
+void VirtualKeyScanner::actOnRawMatrixScan() {
+
   n_pressed_switches_            = 0;
   n_previously_pressed_switches_ = 0;
 
@@ -267,8 +301,9 @@ void VirtualKeyScanner::actOnMatrixScan() {
     }
 
     if (key_state != 0)
-      handleKeyswitchEvent(Key_NoKey, key_addr, key_state);
+      handleKeyswitchEvent(Key_NoKey, key_addr, key_state, timestamps_[key_addr.toInt()]);
     keystates_prev_[key_addr.toInt()] = keystates_[key_addr.toInt()];
+    timestamps_[key_addr.toInt()]     = 0;
 
     if (keystates_[key_addr.toInt()] == KeyState::Tap) {
       key_state = WAS_PRESSED & ~IS_PRESSED;
@@ -279,10 +314,82 @@ void VirtualKeyScanner::actOnMatrixScan() {
   }
 }
 
+void VirtualKeyScanner::actOnDebouncedMatrixScan() {
+
+  n_pressed_switches_            = 0;
+  n_previously_pressed_switches_ = 0;
+
+  RowState scanned[matrix_rows];  // NOLINT(runtime/arrays)
+  for (uint8_t row = 0; row < matrix_rows; row++) {
+    RowState sample = 0;
+    for (uint8_t col = 0; col < matrix_columns; col++) {
+      uint8_t i = KeyAddr(row, col).toInt();
+      if (keystates_[i] != KeyState::NotPressed)
+        sample |= RowState(1) << col;
+      // A tap is a single sample, so whether it turns into a keypress is up
+      // to the debouncer.
+      if (keystates_[i] == KeyState::Tap)
+        keystates_[i] = KeyState::NotPressed;
+      keystates_prev_[i] = keystates_[i];
+    }
+
+    // With ghost detection on, but no debounce filter, samples are taken as
+    // they come.
+    if (debounce_filter_ != nullptr) {
+      scanned[row] = debounced_[row] ^ debounce_filter_->debounce(row, sample);
+    } else {
+      scanned[row] = sample;
+    }
+  }
+
+  // Like the hardware key scanners, only accept the state of keys that can't
+  // be ghosts.
+  if (ghost_detection_) {
+    kaleidoscope::driver::keyscanner::GhostFilter<RowState, matrix_rows> ghosts;
+    ghosts.detect([&scanned](uint8_t row) {
+      return scanned[row];
+    });
+    for (uint8_t row = 0; row < matrix_rows; row++)
+      scanned[row] = ghosts.filter(row, scanned[row], debounced_[row]);
+  }
+
+  for (uint8_t row = 0; row < matrix_rows; row++) {
+    debounced_prev_[row] = debounced_[row];
+    debounced_[row]      = scanned[row];
+
+    for (uint8_t col = 0; col < matrix_columns; col++) {
+      KeyAddr key_addr(row, col);
+      uint8_t key_state = 0;
+      if (bitRead(debounced_prev_[row], col)) {
+        key_state |= WAS_PRESSED;
+        ++n_previously_pressed_switches_;
+      }
+      if (bitRead(debounced_[row], col)) {
+        key_state |= IS_PRESSED;
+        ++n_pressed_switches_;
+      }
+      if (key_state == 0)
+        continue;
+
+      // The detection time belongs to the raw change, so it's kept until the
+      // debouncer lets a change through.
+      uint32_t timestamp = 0;
+      if (key_state != (WAS_PRESSED | IS_PRESSED)) {
+        timestamp                     = timestamps_[key_addr.toInt()];
+        timestamps_[key_addr.toInt()] = 0;
+      }
+      handleKeyswitchEvent(Key_NoKey, key_addr, key_state, timestamp);
+    }
+  }
+}
+
 uint8_t VirtualKeyScanner::pressedKeyswitchCount() const {
   return n_pressed_switches_;
 }
 bool VirtualKeyScanner::isKeyswitchPressed(KeyAddr key_addr) const {
+  if (scansRowStates())
+    return bitRead(debounced_[key_addr.row()], key_addr.col());
+
   if (keystates_[key_addr.toInt()] == KeyState::NotPressed) {
     return false;
   }
@@ -293,6 +400,9 @@ uint8_t VirtualKeyScanner::previousPressedKeyswitchCount() const {
   return n_previously_pressed_switches_;
 }
 bool VirtualKeyScanner::wasKeyswitchPressed(KeyAddr key_addr) const {
+  if (scansRowStates())
+    return bitRead(debounced_prev_[key_addr.row()], key_addr.col());
+
   if (keystates_prev_[key_addr.toInt()] == KeyState::NotPressed) {
     return false;
   }
@@ -300,14 +410,92 @@ bool VirtualKeyScanner::wasKeyswitchPressed(KeyAddr key_addr) const {
   return true;
 }
 
+bool VirtualKeyScanner::scanPending() const {
+  // When reading from the input stream, there's no telling when the next line
+  // will come in, so we never skip a scan.
+  if (read_matrix_enabled_)
+    return true;
+
+  if (idle_tracker_.isIdle())
+    return anyKeyswitchDown();
+
+  // A debouncer may be part way through counting a change.
+  if (debounce_filter_ != nullptr)
+    return true;
+
+  for (auto key_addr : KeyAddr::all()) {
+    if (keystates_[key_addr.toInt()] != keystates_prev_[key_addr.toInt()])
+      return true;
+  }
+
+  return false;
+}
+
 void VirtualKeyScanner::setKeystate(KeyAddr keyAddr, KeyState ks) {
-  keystates_[keyAddr.toInt()] = ks;
+  setKeystate(keyAddr, ks, 0);
+}
+
+void VirtualKeyScanner::setKeystate(KeyAddr keyAddr, KeyState ks, uint32_t timestamp) {
+  keystates_[keyAddr.toInt()]  = ks;
+  timestamps_[keyAddr.toInt()] = timestamp;
 }
 
 VirtualKeyScanner::KeyState VirtualKeyScanner::getKeystate(KeyAddr keyAddr) const {
   return keystates_[keyAddr.toInt()];
 }
 
+void VirtualKeyScanner::setDebounceFilter(DebounceFilter *filter) {
+  debounce_filter_ = filter;
+  if (debounce_filter_ != nullptr)
+    debounce_filter_->reset();
+  for (uint8_t row = 0; row < matrix_rows; row++) {
+    debounced_[row]      = 0;
+    debounced_prev_[row] = 0;
+  }
+}
+
+void VirtualKeyScanner::setGhostDetection(bool enabled) {
+  ghost_detection_ = enabled;
+  for (uint8_t row = 0; row < matrix_rows; row++) {
+    debounced_[row]      = 0;
+    debounced_prev_[row] = 0;
+  }
+}
+
+void VirtualKeyScanner::raiseDebounce(KeyAddr key_addr) {
+  if (debounce_filter_ != nullptr)
+    debounce_filter_->penalize(key_addr.row(), key_addr.col());
+}
+
+void VirtualKeyScanner::setIdleTimeout(uint16_t timeout) {
+  idle_tracker_.setTimeout(timeout);
+  idle_tracker_.wake(Runtime.millisAtCycleStart());
+}
+
+bool VirtualKeyScanner::anyKeyswitchDown() const {
+  for (auto key_addr : KeyAddr::all()) {
+    if (keystates_[key_addr.toInt()] != KeyState::NotPressed) return true;
+  }
+
+  return false;
+}
+
+// Whether the next scan sees a key change, or one that a debouncer is still
+// counting.
+bool VirtualKeyScanner::anyKeyswitchChanging() const {
+  for (auto key_addr : KeyAddr::all()) {
+    KeyState state = keystates_[key_addr.toInt()];
+    bool pressed   = state != KeyState::NotPressed;
+    if (scansRowStates()) {
+      if (pressed != bitRead(debounced_[key_addr.row()], key_addr.col()))
+        return true;
+    } else if (state != keystates_prev_[key_addr.toInt()]) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool VirtualKeyScanner::anythingHeld() {
   for (auto key_addr : KeyAddr::all()) {
     if (keystates_[key_addr.toInt()] == KeyState::Pressed) return true;
@@ -31,15 +31,19 @@
 #include KALEIDOSCOPE_HARDWARE_H
 
 // From system:
-#include <stdint.h>  // for uint8_t
+#include <stdint.h>  // for uint8_t, uint32_t
 // From Arduino libraries:
 #include <HardwareSerial.h>  // for Serial
 // From Kaleidoscope:
-#include "kaleidoscope/device/Base.h"             // for Base
-#include "kaleidoscope/driver/bootloader/None.h"  // for None
-#include "kaleidoscope/driver/hid/Keyboardio.h"   // for Keyboardio
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for Base
-#include "kaleidoscope/driver/mcu/None.h"         // for None
+#include "kaleidoscope/device/Base.h"                    // for Base
+#include "kaleidoscope/driver/bootloader/None.h"         // for None
+#include "kaleidoscope/driver/hid/Keyboardio.h"          // for Keyboardio
+#include "kaleidoscope/driver/hid/ReportQueue.h"         // for ReportQueue, ReportQueueStats
+#include "kaleidoscope/driver/keyscanner/Base.h"         // for Base
+#include "kaleidoscope/driver/keyscanner/GhostFilter.h"  // for GhostFilter
+#include "kaleidoscope/driver/keyscanner/IdleTracker.h"  // for IdleTracker
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"     // for ScanRate
+#include "kaleidoscope/driver/mcu/None.h"                // for None
 
 namespace kaleidoscope {
 namespace device {
@@ -63,6 +67,46 @@ class VirtualKeyScanner
   static constexpr uint8_t matrix_rows    = kaleidoscope::DeviceProps::KeyScannerProps::matrix_rows;
   static constexpr uint8_t matrix_columns = kaleidoscope::DeviceProps::KeyScannerProps::matrix_columns;
 
+  typedef uint32_t RowState;
+  static_assert(matrix_columns <= sizeof(RowState) * 8,
+                "The virtual key scanner's RowState is too narrow for the matrix");
+
+  /* Debouncing for the simulated matrix
+   *
+   * By default, the virtual key scanner reports every key state change in the
+   * cycle it was made, as if the matrix never bounced. To test a debounce
+   * policy, wrap it in a `Debounced` filter and install that with
+   * `setDebounceFilter()`: every cycle then counts as one matrix scan, and the
+   * key states set by the simulator are the raw samples fed to the policy.
+   */
+  class DebounceFilter {
+   public:
+    virtual void reset()                                    = 0;
+    virtual RowState debounce(uint8_t row, RowState sample) = 0;
+    virtual void penalize(uint8_t row, uint8_t col)         = 0;
+  };
+
+  template<typename _Debouncer>
+  class Debounced : public DebounceFilter {
+   public:
+    void reset() override {
+      for (auto &debouncer : debouncers_)
+        debouncer = _Debouncer();
+    }
+    RowState debounce(uint8_t row, RowState sample) override {
+      return debouncers_[row].debounce(sample);
+    }
+    void penalize(uint8_t row, uint8_t col) override {
+      debouncers_[row].penalize(col);
+    }
+    _Debouncer &row(uint8_t row) {
+      return debouncers_[row];
+    }
+
+   private:
+    _Debouncer debouncers_[matrix_rows];  // NOLINT(runtime/arrays)
+  };
+
   VirtualKeyScanner();
 
   void setup();
@@ -72,6 +116,7 @@ class VirtualKeyScanner
     this->actOnMatrixScan();
   }
   void actOnMatrixScan();
+  bool scanPending() const;
 
   uint8_t pressedKeyswitchCount() const;
   bool isKeyswitchPressed(KeyAddr key_addr) const;
@@ -84,10 +129,59 @@ class VirtualKeyScanner
   }
 
   void setKeystate(KeyAddr keyAddr, KeyState ks);
+  // Same as above, but the resulting event gets the given detection time (a
+  // `micros()` value).
+  void setKeystate(KeyAddr keyAddr, KeyState ks, uint32_t timestamp);
   KeyState getKeystate(KeyAddr keyAddr) const;
 
+  // Install a debounce filter (or remove it, with `nullptr`). The filter is
+  // reset, and all keys start out released, so this should only be called
+  // while no keys are held.
+  void setDebounceFilter(DebounceFilter *filter);
+  // Raises the debounce time of a chattering key, if the debounce filter's
+  // policy can.
+  void raiseDebounce(KeyAddr key_addr);
+
+  // Simulate a matrix without diodes, as far as the key scanner can tell: keys
+  // that might be ghosts keep their previous state (see `GhostFilter`). The
+  // simulator doesn't add ghosts itself, so to test this, press all four
+  // corners of a rectangle. All keys start out released, so this should only
+  // be called while no keys are held.
+  void setGhostDetection(bool enabled);
+
+  // Handle all the changes found in a cycle as one batch, the way the nRF52
+  // key scanner does, so that their keyboard reports get coalesced.
+  void setEventBatching(bool enabled) {
+    event_batching_ = enabled;
+  }
+
+  // Like the hardware key scanners, the virtual one can stop scanning once no
+  // key has been down for `timeout` milliseconds, and only check whether any
+  // key is down until one is. Zero (the default) disables idling.
+  void setIdleTimeout(uint16_t timeout);
+  bool isIdle() const {
+    return idle_tracker_.isIdle();
+  }
+
+  // Like the hardware key scanners, the virtual one can scan less often while
+  // no key is changing. Every cycle is a chance to scan, at its start time,
+  // and cycles that come before the next scan is due are skipped, so changes
+  // made in between are only seen by the scan after them. By default, the
+  // rate is fixed, and every cycle scans the matrix.
+  kaleidoscope::driver::keyscanner::ScanRate *scanRate() {
+    return &scan_rate_;
+  }
+
  private:
   bool anythingHeld();
+  bool anyKeyswitchDown() const;
+  bool anyKeyswitchChanging() const;
+  void actOnRawMatrixScan();
+  void actOnDebouncedMatrixScan();
+  // Whether key states are kept as row bitmaps, in `debounced_`.
+  bool scansRowStates() const {
+    return debounce_filter_ != nullptr || ghost_detection_;
+  }
 
  private:
   uint8_t n_pressed_switches_,
@@ -97,6 +191,43 @@ class VirtualKeyScanner
 
   KeyState keystates_[matrix_rows * matrix_columns];       // NOLINT(runtime/arrays)
   KeyState keystates_prev_[matrix_rows * matrix_columns];  // NOLINT(runtime/arrays)
+  uint32_t timestamps_[matrix_rows * matrix_columns];      // NOLINT(runtime/arrays)
+
+  DebounceFilter *debounce_filter_ = nullptr;
+  bool ghost_detection_            = false;
+  bool event_batching_             = false;
+  kaleidoscope::driver::keyscanner::IdleTracker idle_tracker_;
+  kaleidoscope::driver::keyscanner::ScanRate scan_rate_;
+  uint32_t last_scan_micros_ = 0;
+  RowState debounced_[matrix_rows];       // NOLINT(runtime/arrays)
+  RowState debounced_prev_[matrix_rows];  // NOLINT(runtime/arrays)
+};
+
+// The simulated host takes every report right away, so the HID driver never
+// needs to queue any. It has a report queue all the same, which stays empty
+// unless a test fills it, so that what the firmware does while reports are
+// waiting to be sent can be tested too.
+class VirtualHID
+  : public kaleidoscope::driver::hid::Keyboardio<kaleidoscope::driver::hid::KeyboardioProps> {
+ public:
+  typedef kaleidoscope::driver::hid::ReportQueue<4, 8> ReportQueue;
+
+  ReportQueue &reportQueue() {
+    return report_queue_;
+  }
+
+  bool hasQueuedReports() {
+    return !report_queue_.empty();
+  }
+
+  kaleidoscope::driver::hid::ReportQueueStats reportQueueStats() {
+    auto stats = kaleidoscope::driver::hid::ReportQueueStats();
+    report_queue_.addStatsTo(stats);
+    return stats;
+  }
+
+ private:
+  ReportQueue report_queue_;
 };
 
 class VirtualLEDDriver
@@ -121,7 +252,7 @@ class VirtualLEDDriver
 //
 struct VirtualProps : public kaleidoscope::DeviceProps {
   typedef kaleidoscope::driver::hid::KeyboardioProps HIDProps;
-  typedef kaleidoscope::driver::hid::Keyboardio<HIDProps> HID;
+  typedef VirtualHID HID;
   typedef typename kaleidoscope::DeviceProps::KeyScannerProps
     KeyScannerProps;
   typedef VirtualKeyScanner
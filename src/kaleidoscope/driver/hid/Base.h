@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "ReportQueue.h"         // for ReportQueueStats
 #include "base/AbsoluteMouse.h"  // for AbsoluteMouse, AbsoluteMouseProps
 #include "base/Keyboard.h"       // for Keyboard, KeyboardProps
 #include "base/Mouse.h"          // for Mouse, MouseProps
@@ -57,6 +58,21 @@ class Base {
     keyboard().onUSBReset();
   }
 
+  // Called once per cycle, after the plugins are done with it, so that drivers
+  // that queue their reports get to send the ones the host wasn't ready for.
+  void betweenCycles() {}
+
+  // Whether the driver has reports waiting for `betweenCycles()` to send
+  // them, in which case the main loop must not go to sleep.
+  bool hasQueuedReports() {
+    return false;
+  }
+
+  // The state of the driver's report queues, if it has any.
+  ReportQueueStats reportQueueStats() {
+    return ReportQueueStats();
+  }
+
   auto keyboard() -> decltype(keyboard_) & {
     return keyboard_;
   }
@@ -43,7 +43,12 @@ struct BluefruitProps : public BaseProps {
 };
 
 template<typename _Props>
-class Bluefruit : public Base<_Props> {};
+class Bluefruit : public Base<_Props> {
+ public:
+  ReportQueueStats reportQueueStats() {
+    return bluefruit::blehid.reportQueueStats();
+  }
+};
 
 }  // namespace hid
 }  // namespace driver
@@ -57,6 +57,28 @@ class Hybrid {
     hidusb.keyboard().onUSBReset();
   }
 
+  void betweenCycles() {
+    hidusb.betweenCycles();
+    hidble.betweenCycles();
+  }
+
+  // The BLE driver sends its reports from a task of its own, so only the USB
+  // one needs the main loop to stay awake.
+  bool hasQueuedReports() {
+    return hidusb.hasQueuedReports();
+  }
+
+  ReportQueueStats reportQueueStats() {
+    ReportQueueStats usb   = hidusb.reportQueueStats();
+    ReportQueueStats ble   = hidble.reportQueueStats();
+    ReportQueueStats stats = {
+      uint8_t(usb.queued + ble.queued),
+      uint16_t(usb.coalesced + ble.coalesced),
+      uint16_t(usb.dropped + ble.dropped),
+    };
+    return stats;
+  }
+
   base::KeyboardItf &keyboard() {
     if (host_connection_mode_ == MODE_USB) {
       return hidusb.keyboard();
@@ -0,0 +1,140 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/driver/hid/ReportQueue.h"  // for ReportQueue, Coalesce, ReportQueueStats
+
+namespace kaleidoscope {
+namespace driver {
+namespace hid {
+
+/// What a report pushed into a `PrioritizedReportQueue` carries
+enum class ReportKind : uint8_t {
+  /// Keyboard, consumer or system control state
+  Keys,
+  /// A relative mouse report: a button byte, followed by signed movement
+  RelativeMouse,
+  /// An absolute mouse report
+  AbsoluteMouse,
+};
+
+/* Two report queues, one for key reports, and one for mouse movement
+ *
+ * Key reports, and mouse reports that change the buttons, are order
+ * sensitive, and go into the key queue, which keeps all of them in order, and
+ * only leaves out repeats.
+ *
+ * Mouse reports that only move the pointer or the wheel go into the mouse
+ * queue, where they're added together, and are only taken while the key queue
+ * is empty, so that they don't hold up key reports on a busy link. When a
+ * button changes, the movement queued before it is moved over to the key
+ * queue first, so that the click still happens where the pointer was.
+ *
+ * Report IDs are only used to tell reports apart, so a driver can use IDs of
+ * its own for reports that don't have one, such as boot protocol reports, as
+ * long as each kind of report gets a different one. Every report is taken out
+ * with the ID it was pushed with.
+ */
+template<uint8_t _key_depth, uint8_t _mouse_depth, uint8_t _max_len>
+class PrioritizedReportQueue {
+ public:
+  /// Whether `push()` would put the report in the key queue, so a driver
+  /// that wants to wait for room there knows to do so.
+  bool goesToKeyQueue(const void *data, ReportKind kind) const {
+    return kind == ReportKind::Keys ||
+           (kind == ReportKind::RelativeMouse && buttons(data) != mouse_buttons_);
+  }
+
+  bool keyQueueFull() const {
+    return key_queue_.size() == _key_depth;
+  }
+
+  void push(uint8_t report_id, const void *data, uint8_t len, ReportKind kind) {
+    if (kind == ReportKind::Keys) {
+      key_queue_.push(report_id, data, len, Coalesce::State);
+      return;
+    }
+    if (kind == ReportKind::AbsoluteMouse) {
+      absolute_mouse_id_ = report_id;
+      mouse_queue_.push(report_id, data, len, Coalesce::State);
+      return;
+    }
+    if (buttons(data) == mouse_buttons_) {
+      // Movement is never waited for: when the queue is full, it's added up.
+      mouse_queue_.push(report_id, data, len, Coalesce::MouseDeltas);
+      return;
+    }
+
+    mouse_buttons_ = buttons(data);
+    uint8_t movement_id;
+    uint8_t movement[_max_len];  // NOLINT(runtime/arrays)
+    uint8_t movement_len;
+    while ((movement_len = mouse_queue_.take(movement_id, movement)) != 0) {
+      key_queue_.push(movement_id, movement, movement_len,
+                      movement_id == absolute_mouse_id_ ? Coalesce::State : Coalesce::MouseDeltas);
+    }
+    key_queue_.push(report_id, data, len, Coalesce::MouseDeltas);
+  }
+
+  /// Takes the next report to send, key reports first, and returns its
+  /// length, or 0 if both queues are empty. `data` needs room for `_max_len`
+  /// bytes.
+  uint8_t take(uint8_t &report_id, uint8_t *data) {
+    uint8_t len = key_queue_.take(report_id, data);
+    if (len == 0)
+      len = mouse_queue_.take(report_id, data);
+    return len;
+  }
+
+  bool empty() const {
+    return key_queue_.empty() && mouse_queue_.empty();
+  }
+
+  void clear() {
+    key_queue_.clear();
+    mouse_queue_.clear();
+    mouse_buttons_ = 0;
+  }
+
+  void addStatsTo(ReportQueueStats &stats) const {
+    key_queue_.addStatsTo(stats);
+    mouse_queue_.addStatsTo(stats);
+  }
+
+ private:
+  static uint8_t buttons(const void *data) {
+    return static_cast<const uint8_t *>(data)[0];
+  }
+
+  ReportQueue<_key_depth, _max_len> key_queue_;
+  ReportQueue<_mouse_depth, _max_len> mouse_queue_;
+  uint8_t mouse_buttons_     = 0;
+  // Only meaningful while absolute movement is queued, which sets it
+  uint8_t absolute_mouse_id_ = 0;
+};
+
+}  // namespace hid
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,226 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, int8_t
+#include <string.h>  // for memcmp, memcpy
+
+namespace kaleidoscope {
+namespace driver {
+namespace hid {
+
+/// How a report may be combined with a queued one of the same report ID
+enum class Coalesce : uint8_t {
+  /// Reports that carry the state of a set of keys (keyboard, consumer and
+  /// system control, absolute mouse). Each of them has to reach the host, in
+  /// order, so that no key change is lost or reordered; only an exact repeat
+  /// of the newest queued report is left out. When the queue is full, the
+  /// newest queued report is replaced, because the host only has to end up
+  /// with the right keys held.
+  State,
+  /// Relative mouse reports: a button byte, followed by signed 8-bit
+  /// movement. Movement with the same buttons is added to the newest queued
+  /// report, for as long as the sums fit. When the queue is full, it's added
+  /// even across a button change, which can lose a click, but not movement.
+  MouseDeltas,
+};
+
+/// How much combining and dropping a HID driver's report queues have done,
+/// and how many reports are waiting in them
+struct ReportQueueStats {
+  uint8_t queued;
+  uint16_t coalesced;
+  uint16_t dropped;
+};
+
+/* A queue of HID reports waiting for the endpoint
+ *
+ * A HID driver pushes its reports here instead of waiting for the endpoint to
+ * become ready, and calls `flush()` whenever it gets the chance: right after
+ * pushing, and once per cycle. `flush()` hands the queued reports to the
+ * endpoint, oldest first, for as long as it's ready to take them. The endpoint
+ * can be any object with these two methods:
+ *
+ *   bool ready();
+ *   bool sendReport(uint8_t report_id, const void *data, uint8_t len);
+ *
+ * The queue holds up to `_depth` reports of up to `_max_len` bytes each, and
+ * counts the reports that were combined with others (see `Coalesce`), and the
+ * ones that had to be dropped to make room.
+ */
+template<uint8_t _depth, uint8_t _max_len>
+class ReportQueue {
+ public:
+  void push(uint8_t report_id, const void *data, uint8_t len, Coalesce coalesce) {
+    if (len > _max_len)
+      len = _max_len;
+
+    Entry *newest = newestWithId(report_id);
+    if (newest != nullptr && combine(*newest, data, len, coalesce, false)) {
+      ++coalesced_;
+      return;
+    }
+
+    if (count_ == _depth) {
+      if (newest != nullptr && combine(*newest, data, len, coalesce, true)) {
+        ++coalesced_;
+        return;
+      }
+      // Nothing to combine the report with: make room by dropping the oldest.
+      pop();
+      ++dropped_;
+    }
+
+    Entry &entry    = entries_[(head_ + count_) % _depth];
+    entry.report_id = report_id;
+    entry.len       = len;
+    memcpy(entry.data, data, len);
+    ++count_;
+  }
+
+  /// Sends queued reports while the endpoint is ready for them, and returns
+  /// how many it sent.
+  template<typename _Endpoint>
+  uint8_t flush(_Endpoint &endpoint) {
+    uint8_t sent = 0;
+    while (count_ != 0 && endpoint.ready()) {
+      const Entry &entry = entries_[head_];
+      if (!endpoint.sendReport(entry.report_id, entry.data, entry.len))
+        break;
+      pop();
+      ++sent;
+    }
+    return sent;
+  }
+
+  /// Takes the oldest report out of the queue, for a driver that sends it on
+  /// its own, and returns its length, or 0 if the queue is empty. `data` needs
+  /// room for `_max_len` bytes. Once taken, the report is no longer combined
+  /// with later ones.
+  uint8_t take(uint8_t &report_id, uint8_t *data) {
+    if (count_ == 0)
+      return 0;
+    const Entry &entry = entries_[head_];
+    const uint8_t len  = entry.len;
+    report_id          = entry.report_id;
+    memcpy(data, entry.data, len);
+    pop();
+    return len;
+  }
+
+  uint8_t size() const {
+    return count_;
+  }
+  bool empty() const {
+    return count_ == 0;
+  }
+  void clear() {
+    head_  = 0;
+    count_ = 0;
+  }
+
+  uint16_t coalescedCount() const {
+    return coalesced_;
+  }
+  uint16_t droppedCount() const {
+    return dropped_;
+  }
+  void addStatsTo(ReportQueueStats &stats) const {
+    stats.queued += count_;
+    stats.coalesced += coalesced_;
+    stats.dropped += dropped_;
+  }
+  void resetCounts() {
+    coalesced_ = 0;
+    dropped_   = 0;
+  }
+
+ private:
+  struct Entry {
+    uint8_t report_id;
+    uint8_t len;
+    uint8_t data[_max_len];  // NOLINT(runtime/arrays)
+  };
+
+  Entry *newestWithId(uint8_t report_id) {
+    for (uint8_t i = count_; i-- > 0;) {
+      Entry &entry = entries_[(head_ + i) % _depth];
+      if (entry.report_id == report_id)
+        return &entry;
+    }
+    return nullptr;
+  }
+
+  void pop() {
+    head_ = (head_ + 1) % _depth;
+    --count_;
+  }
+
+  // Combines the report with the queued `entry`, if the rules of `coalesce`
+  // allow it, and returns whether it did. With `full`, the queue has no room
+  // for the report, and the rules are relaxed.
+  bool combine(Entry &entry, const void *data, uint8_t len, Coalesce coalesce, bool full) {
+    if (entry.len != len)
+      return false;
+    const uint8_t *report = static_cast<const uint8_t *>(data);
+
+    if (coalesce == Coalesce::State) {
+      // Only a repeat of the newest report in the queue can go, or anything
+      // in between would be undone.
+      if (!full && !(&entry == &newest() && memcmp(entry.data, report, len) == 0))
+        return false;
+      memcpy(entry.data, report, len);
+      return true;
+    }
+
+    if (!full && entry.data[0] != report[0])
+      return false;
+    int16_t sums[_max_len];  // NOLINT(runtime/arrays)
+    for (uint8_t i = 1; i < len; i++) {
+      sums[i] = int16_t(int8_t(entry.data[i])) + int8_t(report[i]);
+      if (sums[i] > 127 || sums[i] < -128) {
+        if (!full)
+          return false;
+        sums[i] = sums[i] > 0 ? 127 : -128;
+      }
+    }
+    entry.data[0] = report[0];
+    for (uint8_t i = 1; i < len; i++)
+      entry.data[i] = uint8_t(int8_t(sums[i]));
+    return true;
+  }
+
+  Entry &newest() {
+    return entries_[(head_ + count_ - 1) % _depth];
+  }
+
+  Entry entries_[_depth];  // NOLINT(runtime/arrays)
+  uint8_t head_       = 0;
+  uint8_t count_      = 0;
+  uint16_t coalesced_ = 0;
+  uint16_t dropped_   = 0;
+};
+
+}  // namespace hid
+}  // namespace driver
+}  // namespace kaleidoscope
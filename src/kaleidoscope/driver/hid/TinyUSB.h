@@ -47,7 +47,34 @@ struct TinyUSBProps : public BaseProps {
 };
 
 template<typename _Props>
-class TinyUSB : public Base<_Props> {};
+class TinyUSB : public Base<_Props> {
+ public:
+  void betweenCycles() {
+    tinyusb::BootKeyboard().flushReports();
+    tinyusb::TUSBMultiReport().flushReports();
+#if CFG_TUD_HID > 2
+    tinyusb::TUSBAbsoluteMouse().flushReports();
+#endif
+  }
+
+  bool hasQueuedReports() {
+    return tinyusb::BootKeyboard().hasQueuedReports() ||
+#if CFG_TUD_HID > 2
+           tinyusb::TUSBAbsoluteMouse().hasQueuedReports() ||
+#endif
+           tinyusb::TUSBMultiReport().hasQueuedReports();
+  }
+
+  ReportQueueStats reportQueueStats() {
+    ReportQueueStats stats = ReportQueueStats();
+    tinyusb::BootKeyboard().addReportQueueStats(stats);
+    tinyusb::TUSBMultiReport().addReportQueueStats(stats);
+#if CFG_TUD_HID > 2
+    tinyusb::TUSBAbsoluteMouse().addReportQueueStats(stats);
+#endif
+    return stats;
+  }
+};
 
 }  // namespace hid
 }  // namespace driver
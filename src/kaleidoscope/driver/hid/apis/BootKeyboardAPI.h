@@ -185,6 +185,8 @@ class BootKeyboardAPI {
   inline size_t release(uint8_t k);
   inline void releaseAll();
 
+  // Sends the changes since the last call, in as few reports as the ordering of
+  // modifiers and other keys allows, and returns how many that took.
   inline int sendReport();
 
   inline bool isModifierActive(uint8_t k);
@@ -129,50 +129,54 @@ int BootKeyboardAPI::sendReportUnchecked() {
 // 1. A report with toggled-off non-modifiers removed.
 // 2. A report with changes to modifiers.
 // 3. A report with toggled-on non-modifiers added.
+//
+// Only the reports that are needed get sent, though. Without a modifier change,
+// all non-modifier changes go out in a single report, and a modifier change
+// only needs the reports for the non-modifier changes that come with it. Each
+// report is likely to take a USB frame of its own, so the plain keystrokes that
+// make up most typing, and any rollover between them, need to stay at one. The
+// return value is the number of reports sent, from zero to three.
 
 int BootKeyboardAPI::sendReport() {
-  // If the new HID report differs from the previous one both in active modifier
-  // keycodes and non-modifier keycodes, we will need to send at least one extra
-  // report. First, we compare the modifiers bytes of the two reports.
-  const uint8_t old_modifiers = last_report_.modifiers;
-  const uint8_t new_modifiers = report_.modifiers;
-
-  const uint8_t changed_modifiers = old_modifiers ^ new_modifiers;
-
-  if (changed_modifiers != 0) {
-    // There was at least one modifier change (toggled on or off), remove any
-    // non-modifiers from the stored previous report that toggled off in the new
-    // report, and send it to the host.
-    bool non_modifiers_toggled_off = false;
-    for (uint8_t i = 0; i < NKRO_KEY_BYTES; ++i) {
-      byte released_keycodes = last_report_.keys[i] & ~(report_.keys[i]);
-      if (released_keycodes != 0) {
-        last_report_.keys[i] &= ~released_keycodes;
-        non_modifiers_toggled_off = true;
-      }
-    }
-    if (non_modifiers_toggled_off) {
+  // Find out which of the three reports are needed, in a single pass over the
+  // non-modifier bitmaps.
+  bool keys_released = false;
+  bool keys_pressed  = false;
+  for (uint8_t i = 0; i < NKRO_KEY_BYTES; ++i) {
+    keys_released |= (last_report_.keys[i] & ~report_.keys[i]) != 0;
+    keys_pressed |= (report_.keys[i] & ~last_report_.keys[i]) != 0;
+  }
+  const bool modifiers_changed = last_report_.modifiers != report_.modifiers;
+
+  // A note on errors: if a report fails to send, there's not much we can do to
+  // recover. We could try to send it again, but that would be likely to fail as
+  // well, so it still counts as sent.
+  uint8_t reports_sent = 0;
+
+  if (modifiers_changed) {
+    // Remove any non-modifiers that toggled off from the stored previous
+    // report, and send it to the host, still with the old modifiers.
+    if (keys_released) {
+      for (uint8_t i = 0; i < NKRO_KEY_BYTES; ++i)
+        last_report_.keys[i] &= report_.keys[i];
       sendReportUnchecked();
+      ++reports_sent;
+      keys_released = false;
     }
     // Next, update the modifiers byte of the stored previous report, and send
-    // it.
-    last_report_.modifiers = new_modifiers;
+    // it. Without any non-modifiers toggling on, this is the full new report.
+    last_report_.modifiers = report_.modifiers;
     sendReportUnchecked();
+    ++reports_sent;
   }
 
   // Finally, copy the new report to the previous one, and send it.
-  if (memcmp(last_report_.keys, report_.keys, sizeof(report_.keys)) != 0) {
+  if (keys_released || keys_pressed) {
     memcpy(last_report_.keys, report_.keys, sizeof(report_.keys));
-    return sendReportUnchecked();
+    sendReportUnchecked();
+    ++reports_sent;
   }
-  // A note on return values: Kaleidoscope doesn't actually check the return
-  // value of `sendReport()`, so this function could be changed to return
-  // void. It would be nice if we could do something to recover from an error
-  // here, but it's not at all clear what that should be. Also note that if the
-  // extra reports above return an error, there's not much we can do to try to
-  // recover. We could try to send the report again, but that would be likely to
-  // fail as well.
-  return -1;
+  return reports_sent;
 }
 
 /* Returns true if the modifer key passed in will be sent during this key report
@@ -76,8 +76,30 @@ class ConsumerControlAPI {
  protected:
   virtual void sendReportUnchecked() = 0;
 
+  // The report `sendReportUnchecked()` sends. `sendReport()` builds it from the
+  // set of pressed usages whenever that set changes.
   HID_ConsumerControlReport_Data_t report_;
-  HID_ConsumerControlReport_Data_t last_report_;
+
+ private:
+  // The number of usages a report can hold.
+  static constexpr uint8_t report_size_ = sizeof(HID_ConsumerControlReport_Data_t) / 2;
+
+  // A set of pressed usages. The most common media keys (see `commonUsage()`)
+  // have a bit each in `common`, and up to four other usages are kept in
+  // `other`, sorted, and followed by zeros. The same keys held always result
+  // in the same set, whatever order they were pressed in, so comparing two
+  // sets is enough to tell whether the host needs a new report.
+  struct UsageSet {
+    uint16_t common;
+    uint16_t other[report_size_];  // NOLINT(runtime/arrays)
+  };
+
+  UsageSet pressed_;
+  UsageSet last_sent_;
+
+  static inline uint16_t commonUsage(uint8_t bit);
+  static inline int8_t commonUsageBit(uint16_t usage);
+  inline void buildReport();
 };
 
 #include "ConsumerControlAPI.hpp"
@@ -26,13 +26,13 @@ THE SOFTWARE.
 #pragma once
 
 ConsumerControlAPI::ConsumerControlAPI()
-  : report_{0}, last_report_{0} {}
+  : report_{0}, pressed_{0}, last_sent_{0} {}
 
 void ConsumerControlAPI::begin() {
 }
 
 void ConsumerControlAPI::end() {
-  memset(&report_, 0, sizeof(report_));
+  releaseAll();
   sendReport();
 }
 
@@ -41,40 +41,108 @@ void ConsumerControlAPI::write(uint16_t m) {
   release(m);
 }
 
+// The usages with a bit of their own in the set of pressed usages: the media
+// keys that are pressed the most, and the ones encoders send many times over.
+uint16_t ConsumerControlAPI::commonUsage(uint8_t bit) {
+  static const uint16_t usages[16] PROGMEM = {
+    0xE9,   // Volume Increment
+    0xEA,   // Volume Decrement
+    0xE2,   // Mute
+    0xCD,   // Play/Pause
+    0xB5,   // Scan Next Track
+    0xB6,   // Scan Previous Track
+    0xB7,   // Stop
+    0xB0,   // Play
+    0xB1,   // Pause
+    0xB3,   // Fast Forward
+    0xB4,   // Rewind
+    0xB8,   // Eject
+    0x6F,   // Display Brightness Increment
+    0x70,   // Display Brightness Decrement
+    0x192,  // AL Calculator
+    0x223,  // AC Home
+  };
+  return pgm_read_word(&usages[bit]);
+}
+
+int8_t ConsumerControlAPI::commonUsageBit(uint16_t usage) {
+  for (uint8_t bit = 0; bit < 16; bit++) {
+    if (commonUsage(bit) == usage)
+      return bit;
+  }
+  return -1;
+}
+
 void ConsumerControlAPI::press(uint16_t m) {
-  // search for a free spot
-  for (uint8_t i = 0; i < sizeof(HID_ConsumerControlReport_Data_t) / 2; i++) {
-    if (report_.keys[i] == 0x00) {
-      report_.keys[i] = m;
-      break;
-    }
+  if (m == 0)
+    return;
+
+  int8_t bit = commonUsageBit(m);
+  if (bit >= 0) {
+    pressed_.common |= uint16_t(1) << bit;
+    return;
   }
+
+  // Insert the usage in order, unless it's already there, or there's no room,
+  // in which case it's ignored, like a usage that didn't fit in the report
+  // always was.
+  uint8_t i = 0;
+  while (i < report_size_ && pressed_.other[i] != 0 && pressed_.other[i] < m)
+    i++;
+  if (i == report_size_ || pressed_.other[i] == m ||
+      pressed_.other[report_size_ - 1] != 0)
+    return;
+  for (uint8_t j = report_size_ - 1; j > i; j--)
+    pressed_.other[j] = pressed_.other[j - 1];
+  pressed_.other[i] = m;
 }
 
 void ConsumerControlAPI::release(uint16_t m) {
-  // search and release the keypress
-  for (uint8_t i = 0; i < sizeof(HID_ConsumerControlReport_Data_t) / 2; i++) {
-    if (report_.keys[i] == m) {
-      report_.keys[i] = 0x00;
-      // no break to delete multiple keys
+  int8_t bit = commonUsageBit(m);
+  if (bit >= 0) {
+    pressed_.common &= ~(uint16_t(1) << bit);
+    return;
+  }
+
+  for (uint8_t i = 0; i < report_size_; i++) {
+    if (pressed_.other[i] == m) {
+      for (uint8_t j = i; j < report_size_ - 1; j++)
+        pressed_.other[j] = pressed_.other[j + 1];
+      pressed_.other[report_size_ - 1] = 0;
+      return;
     }
   }
 }
 
 void ConsumerControlAPI::releaseAll() {
+  memset(&pressed_, 0, sizeof(pressed_));
+}
+
+// Fill the report with the pressed usages, the common ones first. If more are
+// pressed than it can hold, the rest are left out until there's room. Only
+// the usages in the set can wait: common ones always, others up to four.
+void ConsumerControlAPI::buildReport() {
   memset(&report_, 0, sizeof(report_));
+  uint8_t n = 0;
+  for (uint8_t bit = 0; bit < 16 && n < report_size_; bit++) {
+    if (pressed_.common & (uint16_t(1) << bit))
+      report_.keys[n++] = commonUsage(bit);
+  }
+  for (uint8_t i = 0; i < report_size_ && n < report_size_; i++) {
+    if (pressed_.other[i] != 0)
+      report_.keys[n++] = pressed_.other[i];
+  }
 }
 
 void ConsumerControlAPI::sendReport() {
-  // If the last report is different than the current report, then we need to
-  // send a report.  We guard sendReport like this so that calling code doesn't
-  // end up spamming the host with empty reports if sendReport is called in a
-  // tight loop.
-
-  // if the previous report is the same, return early without a new report.
-  if (memcmp(&last_report_, &report_, sizeof(report_)) == 0)
+  // Only send a report when the set of pressed usages has changed since the
+  // last one, so that the calling code doesn't end up spamming the host with
+  // identical reports when it rebuilds the set on every key event, or calls
+  // sendReport() in a tight loop.
+  if (memcmp(&last_sent_, &pressed_, sizeof(pressed_)) == 0)
     return;
 
+  buildReport();
   sendReportUnchecked();
-  memcpy(&last_report_, &report_, sizeof(report_));
+  memcpy(&last_sent_, &pressed_, sizeof(pressed_));
 }
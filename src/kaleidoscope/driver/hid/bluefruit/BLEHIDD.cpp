@@ -27,6 +27,7 @@
 #include "kaleidoscope/driver/hid/apis/ConsumerControlAPI.h"
 #include "kaleidoscope/driver/hid/apis/MouseAPI.h"
 #include "kaleidoscope/driver/hid/apis/SystemControlAPI.h"
+#include "kaleidoscope/driver/hid/ReportQueue.h"
 #include "kaleidoscope/driver/hid/bluefruit/HIDD.h"
 #include "kaleidoscope/driver/ble/Bluefruit.h"
 
@@ -87,7 +88,7 @@ static const uint8_t report_desc[] = {
 TaskHandle_t HIDD::report_task_handle_ = nullptr;
 
 HIDD::HIDD()
-  : BLEHidGeneric(5, 1, 0), queue_handle_(nullptr) {}
+  : BLEHidGeneric(5, 1, 0) {}
 
 err_t HIDD::begin() {
   uint16_t in_lens[] = {
@@ -111,14 +112,7 @@ err_t HIDD::begin() {
     return status;
   }
 
-  // Create queue for reports
-  queue_handle_ = xQueueCreateStatic(QUEUE_SIZE,
-                                     sizeof(QueuedReport),
-                                     queue_storage_,
-                                     &queue_buffer_);
-  if (!queue_handle_) {
-    return NRF_ERROR_INTERNAL;
-  }
+  accepting_reports_ = true;
 
   return ERROR_NONE;
 }
@@ -132,7 +126,7 @@ void HIDD::end() {
   // Stop the report processing task if it's running
   stopReportProcessing();
 
-  queue_handle_ = nullptr;  // Static queue doesn't need deletion
+  accepting_reports_ = false;
 }
 
 void HIDD::startReportProcessing() {
@@ -180,7 +174,7 @@ void HIDD::stopReportProcessing() {
     // This ensures the task isn't deleted while it's in the middle of processing a report
     for (int i = 0; i < 10; i++) {
       // Check if there are still reports in the queue
-      if (uxQueueMessagesWaiting(queue_handle_) == 0) {
+      if (!hasQueuedReports()) {
         break;  // No more reports to process, we can delete the task
       }
 
@@ -208,14 +202,25 @@ void HIDD::prepareForSleep() {
 }
 
 void HIDD::clearReportQueue() {
-  if (queue_handle_) {
-    DEBUG_BLE_MSG("Clearing report queue");
-    xQueueReset(queue_handle_);
-  }
+  DEBUG_BLE_MSG("Clearing report queue");
+  taskENTER_CRITICAL();
+  queue_.clear();
+  taskEXIT_CRITICAL();
+  sending_report_ = false;
 }
 
 bool HIDD::hasQueuedReports() const {
-  return queue_handle_ && (uxQueueMessagesWaiting(queue_handle_) > 0);
+  return sending_report_ || !queue_.empty();
+}
+
+ReportQueueStats HIDD::reportQueueStats() const {
+  ReportQueueStats stats = ReportQueueStats();
+  taskENTER_CRITICAL();
+  queue_.addStatsTo(stats);
+  taskEXIT_CRITICAL();
+  if (sending_report_)
+    stats.queued++;
+  return stats;
 }
 
 void HIDD::processReportQueue_(void *pvParameters) {
@@ -227,7 +232,7 @@ void HIDD::processReportQueue_(void *pvParameters) {
     // First, process any reports that are already in the queue
     bool processed_any = false;
 
-    while (uxQueueMessagesWaiting(hidd->queue_handle_) > 0) {
+    while (hidd->hasQueuedReports()) {
       processed_any = true;
 
       // Try to process the next report
@@ -250,7 +255,7 @@ void HIDD::processReportQueue_(void *pvParameters) {
     // Use a critical section to double-check the queue and prepare for sleep
     taskENTER_CRITICAL();
 
-    if (uxQueueMessagesWaiting(hidd->queue_handle_) == 0) {
+    if (!hidd->hasQueuedReports()) {
       // No reports to process, prepare for long sleep
       taskEXIT_CRITICAL();
 
@@ -273,13 +278,12 @@ bool HIDD::processNextReport_() {
     return false;
   }
 
-  QueuedReport report;
-  // Peek at the next report without removing it
-  if (xQueuePeek(queue_handle_, &report, 0) != pdTRUE) {
+  if (!sending_report_ && !takeNextReport_()) {
     return true;  // Queue is empty
   }
 
-  bool success = false;
+  QueuedReport &report = current_report_;
+  bool success         = false;
   switch (report.type) {
   case ReportType::BootKeyboard:
     success = BLEHidGeneric::bootKeyboardReport(report.data, report.length);
@@ -293,90 +297,76 @@ bool HIDD::processNextReport_() {
   }
 
   if (success) {
-    // Only remove the item if send was successful
-    xQueueReceive(queue_handle_, &report, 0);
-
+    sending_report_ = false;
     return true;
   } else if (report.retries_left > 0) {
-    // Update retry count - we need to remove and re-add the item
-    // because FreeRTOS doesn't support in-place updates for multi-item queues
     report.retries_left--;
-
-    // Remove the old item
-    QueuedReport dummy;
-    xQueueReceive(queue_handle_, &dummy, 0);
-
-    // Add it back with updated retry count at the front of the queue
-    if (xQueueSendToFront(queue_handle_, &report, 0) != pdTRUE) {
-      // If we can't re-queue, treat it as a failure
-      DEBUG_BLE_MSG("Failed to re-queue report for retry");
-      return true;
-    }
-
     DEBUG_BLE_MSG("Retrying report, %d retries left", report.retries_left);
     return false;  // Signal failure so we'll wait before next retry
   } else {
-    // Out of retries, remove the failed item
+    // Out of retries, drop the report
     DEBUG_BLE_MSG("Failed to send report, removing from queue");
-    xQueueReceive(queue_handle_, &report, 0);
+    sending_report_ = false;
     return true;
   }
 }
 
-bool HIDD::queueReport_(ReportType type, uint8_t report_id, const void *data, uint8_t length) {
-  if (!queue_handle_) return false;
-
-  // Try to queue the report for 5 seconds before considering eviction
-  const TickType_t QUEUE_RETRY_TIMEOUT = pdMS_TO_TICKS(5000);  // 5 seconds in ticks
-  TickType_t start_time                = xTaskGetTickCount();
-
-  // Keep trying to queue while there's no space and we haven't exceeded our timeout
-  while (uxQueueSpacesAvailable(queue_handle_) == 0) {
-    // Calculate remaining time in our retry window
-    TickType_t now     = xTaskGetTickCount();
-    TickType_t elapsed = now - start_time;
-
-    // If we've exceeded our 5-second retry window, break out to try eviction
-    if (elapsed >= QUEUE_RETRY_TIMEOUT) {
-      DEBUG_BLE_MSG("Failed to queue report, exceeded retry window");
-      break;
-    }
+bool HIDD::takeNextReport_() {
+  QueuedReport &report = current_report_;
 
-    // Wait a short time before checking again
-    // Use shorter delays early in the retry window, longer ones later
-    TickType_t delay_time = (elapsed < pdMS_TO_TICKS(1000)) ? pdMS_TO_TICKS(1) :  // 1ms delays in first second
-                              pdMS_TO_TICKS(10);                                  // 10ms delays after that
-    vTaskDelay(delay_time);
-  }
+  taskENTER_CRITICAL();
+  report.length = queue_.take(report.report_id, report.data);
+  taskEXIT_CRITICAL();
 
-  // If queue is still full after retrying, we need to evict the oldest report
-  if (uxQueueSpacesAvailable(queue_handle_) == 0) {
-    // Log or track this eviction if needed
-    QueuedReport dummy;
-    if (xQueueReceive(queue_handle_, &dummy, 0) != pdTRUE) {
-      // If we somehow failed to remove an item, we can't queue the new one
-      return false;
-    }
-  }
+  if (report.length == 0)
+    return false;
 
-  // Prepare the report structure for queuing
-  QueuedReport report;
-  report.type      = type;
-  report.report_id = report_id;
-  memcpy(report.data, data, length);
-  report.length       = length;
+  if (report.report_id == BOOT_KEYBOARD_REPORT_ID) {
+    report.type = ReportType::BootKeyboard;
+  } else if (report.report_id == BOOT_MOUSE_REPORT_ID) {
+    report.type = ReportType::BootMouse;
+  } else {
+    report.type = ReportType::Input;
+  }
   report.retries_left = MAX_BLE_NOTIFY_RETRIES;
+  sending_report_     = true;
+  return true;
+}
 
-  // Queue the new report
-  BaseType_t success = xQueueSend(queue_handle_, &report, 0);
-
-  if (success == pdTRUE) {
+bool HIDD::queueReport_(ReportType type, uint8_t report_id, const void *data, uint8_t length) {
+  if (!accepting_reports_) return false;
+
+  ReportKind kind = ReportKind::Keys;
+  if (type == ReportType::BootKeyboard) {
+    report_id = BOOT_KEYBOARD_REPORT_ID;
+  } else if (type == ReportType::BootMouse) {
+    report_id = BOOT_MOUSE_REPORT_ID;
+    kind      = ReportKind::RelativeMouse;
+  } else if (report_id == RID_MOUSE) {
+    kind = ReportKind::RelativeMouse;
+  } else if (report_id == RID_ABS_MOUSE) {
+    kind = ReportKind::AbsoluteMouse;
+  }
 
-    // Ensure the report processing task is running
-    startReportProcessing();
+  // Key reports are all kept, so when a macro types faster than the link can
+  // send, wait for room in the queue, rather than combining its keystrokes.
+  // Only once that takes too long is the newest queued state replaced.
+  if (report_task_handle_ != nullptr && queue_.goesToKeyQueue(data, kind)) {
+    TickType_t start_time = xTaskGetTickCount();
+    while (queue_.keyQueueFull() &&
+           xTaskGetTickCount() - start_time < pdMS_TO_TICKS(QUEUE_WAIT_TIMEOUT_MS)) {
+      vTaskDelay(pdMS_TO_TICKS(1));
+    }
   }
 
-  return success == pdTRUE;
+  taskENTER_CRITICAL();
+  queue_.push(report_id, data, length, kind);
+  taskEXIT_CRITICAL();
+
+  // Ensure the report processing task is running
+  startReportProcessing();
+
+  return true;
 }
 
 bool HIDD::sendBootKeyboardReport(const void *data, uint8_t length) {
@@ -26,9 +26,10 @@
 
 #include <bluefruit.h>
 #include "FreeRTOS.h"
-#include "queue.h"
 #include "task.h"
-#include "semphr.h"
+
+#include "kaleidoscope/driver/hid/PrioritizedReportQueue.h"
+#include "kaleidoscope/driver/hid/apis/BootKeyboardAPI.h"
 
 namespace kaleidoscope {
 namespace driver {
@@ -53,10 +54,13 @@ enum class ReportType {
   Input
 };
 
+// The longest report we send is the keyboard report
+constexpr uint8_t MAX_REPORT_LEN = sizeof(HID_BootKeyboardReport_Data_t);
+
 struct QueuedReport {
   ReportType type;
   uint8_t report_id;
-  uint8_t data[32];  // Max HID report size
+  uint8_t data[MAX_REPORT_LEN];
   uint8_t length;
   uint16_t retries_left;
 };
@@ -122,16 +126,37 @@ class HIDD : public BLEHidGeneric {
    */
   void prepareForSleep();
 
+  /**
+   * The number of queued reports, and how many were combined with others or
+   * dropped since the queues were created
+   */
+  ReportQueueStats reportQueueStats() const;
+
  private:
-  static constexpr size_t QUEUE_SIZE               = 512;  // Absurdly large queue size
+  static constexpr uint8_t KEY_QUEUE_DEPTH         = 32;
+  static constexpr uint8_t MOUSE_QUEUE_DEPTH       = 8;
   static constexpr uint16_t MAX_BLE_NOTIFY_RETRIES = 500;
   static constexpr uint8_t RETRY_DELAY_MS          = 10;  // Time between retries
-  static constexpr uint8_t KEYSTROKE_INTERVAL_MS   = 1;
-  ;  // Min time between keystrokes
-  // Queue storage and handle
-  StaticQueue_t queue_buffer_;
-  uint8_t queue_storage_[QUEUE_SIZE * sizeof(QueuedReport)];
-  QueueHandle_t queue_handle_;
+  static constexpr uint8_t KEYSTROKE_INTERVAL_MS   = 1;   // Min time between keystrokes
+  static constexpr uint16_t QUEUE_WAIT_TIMEOUT_MS  = 5000;
+
+  // Boot protocol reports don't have a report ID, so they're queued with
+  // these, which no other report uses
+  static constexpr uint8_t BOOT_KEYBOARD_REPORT_ID = 0;
+  static constexpr uint8_t BOOT_MOUSE_REPORT_ID    = 0xff;
+
+  // Key reports, and mouse reports that change the buttons, are kept in
+  // order, and queued mouse movement is added up, and only sent when no key
+  // report is waiting (see `PrioritizedReportQueue`). The queues are only
+  // touched inside a critical section, because reports are queued from the
+  // main loop, and sent from the report task.
+  PrioritizedReportQueue<KEY_QUEUE_DEPTH, MOUSE_QUEUE_DEPTH, MAX_REPORT_LEN> queue_;
+  bool accepting_reports_ = false;
+
+  // The report being sent. It's taken out of its queue, so that no later
+  // report is combined with it while it's being retried.
+  QueuedReport current_report_;
+  bool sending_report_ = false;
 
   // Task management
   static TaskHandle_t report_task_handle_;
@@ -149,6 +174,12 @@ class HIDD : public BLEHidGeneric {
    */
   bool processNextReport_();
 
+  /**
+   * Take the next report to send out of the queues, key reports first
+   * @return false if both queues are empty
+   */
+  bool takeNextReport_();
+
   /**
    * Queue a report for sending with retry logic
    * @param type Type of report (Boot Keyboard, Boot Mouse, or Input)
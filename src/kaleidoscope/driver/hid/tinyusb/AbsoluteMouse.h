@@ -37,7 +37,7 @@ namespace driver {
 namespace hid {
 namespace tinyusb {
 
-class TUSBAbsoluteMouse_ : public AbsoluteMouseAPI, public HIDD {
+class TUSBAbsoluteMouse_ : public AbsoluteMouseAPI, public HIDD<sizeof(HID_MouseAbsoluteReport_Data_t)> {
  public:
   TUSBAbsoluteMouse_();
   void begin() {
@@ -28,6 +28,7 @@
 
 #include "Adafruit_TinyUSB.h"
 #include "kaleidoscope/driver/hid/Base.h"
+#include "kaleidoscope/driver/hid/ReportQueue.h"
 #include "kaleidoscope/driver/hid/base/Keyboard.h"
 #include "kaleidoscope/driver/hid/apis/ConsumerControlAPI.h"
 #include "kaleidoscope/driver/hid/apis/MouseAPI.h"
@@ -40,6 +41,17 @@ namespace driver {
 namespace hid {
 namespace tinyusb {
 
+/* A TinyUSB HID interface that doesn't wait for the host
+ *
+ * Reports are queued (see `ReportQueue`), and handed to TinyUSB whenever the
+ * endpoint is ready for one: right away if it is, or else on a later call to
+ * `sendReport()` or `flushReports()`, which the HID driver makes once per
+ * cycle. While the host is slow, or asleep, the queue combines the reports
+ * that can be combined, and the keyboard keeps running in the meantime.
+ *
+ * `_max_report_len` is the size of the largest report the interface sends.
+ */
+template<uint8_t _max_report_len>
 class HIDD : public Adafruit_USBD_HID {
  public:
   HIDD(uint8_t const *desc_report,
@@ -48,47 +60,52 @@ class HIDD : public Adafruit_USBD_HID {
        uint8_t interval_ms = 4)
     : Adafruit_USBD_HID(desc_report, len, protocol, interval_ms) {}
 
+  /// Sends as many of the queued reports as the endpoint is ready for.
+  void flushReports() {
+    if (!report_queue_.empty())
+      report_queue_.flush(static_cast<Adafruit_USBD_HID &>(*this));
+  }
+
+  bool hasQueuedReports() const {
+    return !report_queue_.empty();
+  }
+
+  /// Reports combined with others, because the endpoint wasn't ready in time
+  uint16_t coalescedReportCount() const {
+    return report_queue_.coalescedCount();
+  }
+  /// Reports dropped, because the queue was full and they couldn't be combined
+  uint16_t droppedReportCount() const {
+    return report_queue_.droppedCount();
+  }
+  /// Adds the state of the report queue to `stats`.
+  void addReportQueueStats(ReportQueueStats &stats) const {
+    report_queue_.addStatsTo(stats);
+  }
+
  protected:
-  bool sendReport(uint8_t report_id, void const *report, uint8_t len) {
+  bool sendReport(uint8_t report_id, void const *report, uint8_t len,
+                  Coalesce coalesce = Coalesce::State) {
     if (TinyUSBDevice.suspended()) {
-      TinyUSBDevice.remoteWakeup();
       /*
-       * The spec says we should wait for 30ms for a resume.
-       * (USB 2.0 §7.1.7.7)
-       *
+       * The spec says we should wait for 30ms for a resume (USB 2.0 §7.1.7.7):
        * 20ms of host echoing the resume downstream, and 10ms of recovery time
-       * once the bus has resumed.
-       *  
-       * Instead of doing that, we roll that into our blocking delay below, so that
-       * if we're ready earlier, we don't block the runloop and potentially miss
-       * other events
+       * once the bus has resumed. On macOS, the resume and recovery can take
+       * much longer than that.
+       *
+       * Instead of waiting, the report is queued, and sent once the endpoint is
+       * ready again. A key down and key up queued in the meantime both get
+       * there, in order, so a slow resume doesn't cause a stuck key.
        */
+      TinyUSBDevice.remoteWakeup();
     }
-    /*
-     * Block for up to 250ms for endpoint to become ready. If the host is polling,
-     * this should take about 1ms (the requested polling interval, but the
-     * host is allowed to poll less frequently). On resume, especially remote
-     * wakeup on macOS, not only can the resume take longer much than the
-     * minimum (over 2 seconds, instead of 20ms), the recovery period can be
-     * over 100ms (instead of 10ms).
-     *
-     * This will mitigate, but not necessarily eliminate, stuck key situations
-     * during resume. One scenario is a key down report being queued while in
-     * the recovery period, where the bus has resumed, but the host isn't
-     * polling yet. The endpoint will be ready, but the transmission won't
-     * happen until the host resumes polling. The transmission of the key up
-     * event might time out, leading to a stuck key situation.
-     *
-     * Unfortunately, we usually can't abort a packet transmission once queued.
-     */
-    for (int timeout = 250; timeout-- && !ready();) {
-      delay(1);
-    }
-    if (!ready()) {
-      return false;
-    }
-    return Adafruit_USBD_HID::sendReport(report_id, report, len);
+    report_queue_.push(report_id, report, len, coalesce);
+    flushReports();
+    return true;
   }
+
+ private:
+  ReportQueue<8, _max_report_len> report_queue_;
 };
 
 }  // namespace tinyusb
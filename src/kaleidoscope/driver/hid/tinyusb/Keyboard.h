@@ -48,7 +48,7 @@ void boot_keyboard_set_report_cb(uint8_t report_id, hid_report_type_t report_typ
 
 extern class BootKeyboard_ &BootKeyboard();
 
-class BootKeyboard_ : public BootKeyboardAPI, public HIDD {
+class BootKeyboard_ : public BootKeyboardAPI, public HIDD<sizeof(HID_BootKeyboardReport_Data_t)> {
  public:
   explicit BootKeyboard_(uint8_t bootkb_only_ = 0);
   void begin() {
@@ -47,11 +47,19 @@ enum MultiReportIDs {
   RID_SYSTEM_CONTROL,
 };
 
-class TUSBMultiReport_ : public HIDD {
+// The largest of the reports that share the interface; the system control
+// report is a single byte.
+constexpr uint8_t multi_report_max_len =
+  sizeof(HID_ConsumerControlReport_Data_t) > sizeof(HID_MouseReport_Data_t)
+    ? sizeof(HID_ConsumerControlReport_Data_t)
+    : sizeof(HID_MouseReport_Data_t);
+
+class TUSBMultiReport_ : public HIDD<multi_report_max_len> {
  public:
   TUSBMultiReport_();
   void sendReport(uint8_t report_id, const void *data, uint8_t len) {
-    (void)HIDD::sendReport(report_id, data, len);
+    (void)HIDD::sendReport(report_id, data, len,
+                           report_id == RID_MOUSE ? Coalesce::MouseDeltas : Coalesce::State);
   }
 };
 
@@ -23,11 +23,17 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint16_t, uint8_t
-
-#include "kaleidoscope/device/avr/pins_and_ports.h"  // IWYU pragma: keep
-#include "kaleidoscope/driver/keyscanner/Base.h"     // for BaseProps
-#include "kaleidoscope/driver/keyscanner/None.h"     // for None
+#include <stdint.h>  // for uint16_t, uint8_t, UINT16_MAX
+
+#include "kaleidoscope/device/avr/pins_and_ports.h"       // IWYU pragma: keep
+#include "kaleidoscope/driver/keyscanner/Base.h"          // for BaseProps
+#include "kaleidoscope/driver/keyscanner/ColumnReader.h"  // for ColumnReader
+#include "kaleidoscope/driver/keyscanner/Debounce.h"      // for Symmetric
+#include "kaleidoscope/driver/keyscanner/GhostFilter.h"   // for GhostFilter
+#include "kaleidoscope/driver/keyscanner/IdleTracker.h"   // for IdleTracker
+#include "kaleidoscope/driver/keyscanner/None.h"          // for None
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"      // for ScanRate
+#include "kaleidoscope/keyswitch_state.h"                 // for IS_PRESSED, WAS_PRESSED
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 #include <avr/wdt.h>
@@ -39,7 +45,29 @@ namespace keyscanner {
 
 struct ATmegaProps : kaleidoscope::driver::keyscanner::BaseProps {
   static const uint16_t keyscan_interval = 1500;
+  // To scan at `keyscan_interval` only while keys are changing, and slow down
+  // to this interval once they haven't for a while, set it to more than
+  // `keyscan_interval` (see `ScanRate`). Zero keeps the scan rate fixed.
+  static const uint16_t keyscan_slow_interval = 0;
+  // The time it takes the scan interval to double, once no key is changing.
+  static const uint16_t keyscan_decay_millis = 50;
   typedef uint16_t RowState;
+  // Boards that change `RowState` need to change this to match.
+  typedef debounce::Symmetric<RowState> Debouncer;
+  // After this many milliseconds without any key pressed, stop scanning the
+  // matrix row by row (see `setIdleTimeout()`). Zero disables idling.
+  static constexpr uint16_t idle_timeout_millis = 0;
+  // Boards without a diode on every key can turn this on to hold back keys
+  // that might be ghosts (see `GhostFilter`).
+  static constexpr bool ghost_detection = false;
+  // After driving a row, the scanner waits this many nanoseconds before
+  // reading the columns. A column that a key held low for the previous row
+  // is pulled back up by the pin's internal pull-up (at most 50 kOhm on the
+  // ATmega32U4) against the pin's capacitance (under 10 pF) and that of the
+  // switches, diodes and traces on the column (allow 20 pF). It gets past the
+  // input high threshold (0.6 Vcc) within one RC time constant, 1.5 us.
+  // Boards with external pull-ups can lower it.
+  static constexpr uint16_t column_settle_ns = 1500;
 
   /*
    * The following two lines declare an empty array. Both of these must be
@@ -51,6 +79,14 @@ struct ATmegaProps : kaleidoscope::driver::keyscanner::BaseProps {
 
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+// Reads the `PINx` register of a port, for `ColumnReader`.
+struct ATmegaPinRegister {
+  template<uint8_t _port>
+  static uint8_t read() {
+    return _SFR_IO8(ADDRESS_BASE + _port + PIN_OFFSET);
+  }
+};
+
 template<typename _KeyScannerProps>
 class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
  private:
@@ -77,43 +113,89 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
       OUTPUT_HIGH(_KeyScannerProps::matrix_row_pins[i]);
     }
 
-    setScanCycleTime(_KeyScannerProps::keyscan_interval);
+    scan_rate_.setMaxInterval(max_scan_cycle_time);
+    scan_rate_.setFastInterval(_KeyScannerProps::keyscan_interval);
+    scan_rate_.setSlowInterval(_KeyScannerProps::keyscan_slow_interval);
+    scan_rate_.setDecay(_KeyScannerProps::keyscan_decay_millis);
+    scan_rate_.update(true, millis());
+    setScanCycleTime(scan_rate_.interval());
+    setIdleTimeout(_KeyScannerProps::idle_timeout_millis);
   }
 
 
-  /* setScanCycleTime takes a value of between 0 and 8192. This corresponds (roughly) to the number of microseconds to wait between scanning the key matrix. Our debouncing algorithm does four checks before deciding that a result is valid. Most normal mechanical switches specify a 5ms debounce period. On an ATMega32U4, 1700 gets you about 5ms of debouncing.
+  /// The longest scan cycle time Timer1 can count, 8191 at 16MHz.
+  static constexpr uint16_t max_scan_cycle_time = UINT16_MAX / (F_CPU / 2000000);
+
+  /* setScanCycleTime takes a value of between 0 and `max_scan_cycle_time`; longer ones are clamped to it. This corresponds (roughly) to the number of microseconds to wait between scanning the key matrix. The default (`Symmetric`) debouncer does four checks before deciding that a result is valid. Most normal mechanical switches specify a 5ms debounce period. On an ATMega32U4, 1700 gets you about 5ms of debouncing.
 
   Because keycanning is triggered by an interrupt but not run in that interrupt, the actual amount of time between scans is prone to a little bit of jitter.
 
+  With an adaptive scan rate (see `scanRate()`), the scanner calls this itself whenever the interval changes, so a value set from outside only lasts until then.
+
   */
   void setScanCycleTime(uint16_t c) {
+    if (c > max_scan_cycle_time)
+      c = max_scan_cycle_time;
+
     TCCR1B = _BV(WGM13);
     TCCR1A = 0;
 
     const uint32_t cycles = (F_CPU / 2000000) * c;
 
     ICR1   = cycles;
+    TCNT1  = 0;
     TCCR1B = _BV(WGM13) | _BV(CS10);
     TIMSK1 = _BV(TOIE1);
   }
 
+  /* setIdleTimeout sets the number of milliseconds the matrix has to be quiet
+  (no keys pressed, and nothing left to debounce) before the scanner goes idle.
+  While idle, all rows are driven low, and each scan is a single read of the
+  columns, which only turns back into a full scan once a key is pressed. Zero
+  disables idling.
+
+  The AVR pin change interrupts only cover port B, which hardly any board has
+  all of its columns on, so the columns are still polled at the scan rate.
+  */
+  void setIdleTimeout(uint16_t timeout) {
+    idle_tracker_.setTimeout(timeout);
+  }
+
   __attribute__((optimize(2))) void readMatrix(void) {
+    if (idle_tracker_.isIdle()) {
+      // All rows are driven, so any pressed key pulls its column low.
+      if (!readCols())
+        return;
+      wakeMatrix();
+    }
+
     typename _KeyScannerProps::RowState any_debounced_changes = 0;
+    typename _KeyScannerProps::RowState any_hot_pins          = 0;
+    typename _KeyScannerProps::RowState any_pressed           = 0;
+    typename _KeyScannerProps::RowState any_unsettled         = 0;
 
     for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
       OUTPUT_TOGGLE(_KeyScannerProps::matrix_row_pins[current_row]);
+      __builtin_avr_delay_cycles(row_settle_cycles);
       typename _KeyScannerProps::RowState hot_pins = readCols();
 
       OUTPUT_TOGGLE(_KeyScannerProps::matrix_row_pins[current_row]);
 
-      any_debounced_changes |= debounce(hot_pins, &matrix_state_[current_row].debouncer);
-
-      if (any_debounced_changes) {
-        for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
-          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.debounced_state;
-        }
-      }
+      any_debounced_changes |= matrix_state_[current_row].debouncer.debounce(hot_pins);
+      any_hot_pins |= hot_pins;
+      any_pressed |= matrix_state_[current_row].debouncer.state();
+      any_unsettled |= hot_pins ^ matrix_state_[current_row].debouncer.state();
     }
+
+    if (any_debounced_changes)
+      acceptDebouncedState();
+
+    uint32_t now = millis();
+    if (scan_rate_.update(any_debounced_changes || any_unsettled, now))
+      setScanCycleTime(scan_rate_.interval());
+
+    if (idle_tracker_.update(!any_hot_pins && !any_pressed, now))
+      idleMatrix();
   }
   void scanMatrix() {
     if (do_scan_) {
@@ -123,15 +205,31 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
     actOnMatrixScan();
   }
 
+  // The matrix is only read when the scan timer has fired, and until then
+  // there's nothing new to act on.
+  bool scanPending() {
+    return do_scan_;
+  }
+
+  /* Only keyswitches that toggled on or off result in events, so instead of
+   * looking at every key, we XOR the previous and current state of each row,
+   * and only visit the columns whose bits are set. Keys that are simply being
+   * held cost nothing here; plugins that need to know about them can ask with
+   * `isKeyswitchPressed()` or `pressedKeyswitchCount()`.
+   */
   void __attribute__((optimize(2))) actOnMatrixScan() {
     for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
-      for (uint8_t col = 0; col < _KeyScannerProps::matrix_columns; col++) {
-        uint8_t keyState = (bitRead(matrix_state_[row].previous, col) << 0) | (bitRead(matrix_state_[row].current, col) << 1);
-        if (keyState) {
+      typename _KeyScannerProps::RowState current = matrix_state_[row].current;
+      typename _KeyScannerProps::RowState changes = matrix_state_[row].previous ^ current;
+      matrix_state_[row].previous                 = current;
+
+      for (uint8_t col = 0; changes != 0; col++, changes >>= 1) {
+        if (changes & 1) {
+          // The key changed, so if it's pressed now, it wasn't before.
+          uint8_t keyState = bitRead(current, col) ? IS_PRESSED : WAS_PRESSED;
           ThisType::handleKeyswitchEvent(Key_NoKey, typename _KeyScannerProps::KeyAddr(row, col), keyState);
         }
       }
-      matrix_state_[row].previous = matrix_state_[row].current;
     }
   }
 
@@ -160,79 +258,81 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
                     key_addr.col()) != 0);
   }
 
+  void raiseDebounce(typename _KeyScannerProps::KeyAddr key_addr) {
+    matrix_state_[key_addr.row()].debouncer.penalize(key_addr.col());
+  }
+
+  ScanRate *scanRate() {
+    return &scan_rate_;
+  }
+
   bool do_scan_;
 
 
  protected:
-  /*
-    each of these variables are storing the state for a row of keys
+  // Drive all rows low, so that any keypress shows up on the columns.
+  void idleMatrix() {
+    for (uint8_t i = 0; i < _KeyScannerProps::matrix_rows; i++) {
+      OUTPUT_LOW(_KeyScannerProps::matrix_row_pins[i]);
+    }
+  }
 
-    so for key 0, the counter is represented by db0[0] and db1[0]
-    and the state in debounced_state[0].
-  */
-  struct debounce_t {
-    typename _KeyScannerProps::RowState db0;              // counter bit 0
-    typename _KeyScannerProps::RowState db1;              // counter bit 1
-    typename _KeyScannerProps::RowState debounced_state;  // debounced state
-  };
+  void wakeMatrix() {
+    for (uint8_t i = 0; i < _KeyScannerProps::matrix_rows; i++) {
+      OUTPUT_HIGH(_KeyScannerProps::matrix_row_pins[i]);
+    }
+    idle_tracker_.wake(millis());
+  }
+
+  void acceptDebouncedState() {
+    if (_KeyScannerProps::ghost_detection) {
+      GhostFilter<typename _KeyScannerProps::RowState, _KeyScannerProps::matrix_rows> ghosts;
+      ghosts.detect([](uint8_t row) {
+        return matrix_state_[row].debouncer.state();
+      });
+      for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
+        matrix_state_[row].current = ghosts.filter(row,
+                                                   matrix_state_[row].debouncer.state(),
+                                                   matrix_state_[row].current);
+      }
+      return;
+    }
+
+    for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
+      matrix_state_[row].current = matrix_state_[row].debouncer.state();
+    }
+  }
 
   struct row_state_t {
     typename _KeyScannerProps::RowState previous;
     typename _KeyScannerProps::RowState current;
-    debounce_t debouncer;
+    typename _KeyScannerProps::Debouncer debouncer;
   };
 
  private:
   typedef _KeyScannerProps KeyScannerProps_;
   static row_state_t matrix_state_[_KeyScannerProps::matrix_rows];
+  IdleTracker idle_tracker_;
+  ScanRate scan_rate_;
 
   /*
-   * This function has loop unrolling disabled on purpose: we want to give the
-   * hardware enough time to produce stable PIN reads for us. If we unroll the
-   * loop, we will not have that, because even with the NOP, the codepath is too
-   * fast. If we don't have stable reads, then entire rows or columns will behave
-   * erratically.
+   * The columns are read by a `ColumnReader`, generated at compile time from
+   * `matrix_col_pins`, which reads each port that has any columns on it once,
+   * instead of reading the column pins one by one.
    *
-   * For this reason, we ask the compiler to not unroll our loop, which in turn,
-   * gives hardware enough time to produce stable reads, at the cost of a little
-   * bit of speed.
+   * All of the columns are read within a few cycles of each other, so after
+   * toggling a row, we have to wait for the pins to settle first, or entire
+   * rows or columns will behave erratically. That takes `column_settle_ns`,
+   * about 24 cycles at 16 MHz, and at least the one cycle the port's input
+   * synchronizer needs.
    *
-   * Do not remove the attribute!
+   * Do not remove the delay!
    */
-  __attribute__((optimize("no-unroll-loops")))
-  typename _KeyScannerProps::RowState
-  readCols() {
-    typename _KeyScannerProps::RowState hot_pins = 0;
-    for (uint8_t i = 0; i < _KeyScannerProps::matrix_columns; i++) {
-      asm("NOP");  // We need to pause a beat before reading or we may read before the pin is hot
-      hot_pins |= (!READ_PIN(_KeyScannerProps::matrix_col_pins[i]) << i);
-    }
-
-    return hot_pins;
-  }
-
-  static inline typename _KeyScannerProps::RowState debounce(
-    typename _KeyScannerProps::RowState sample, debounce_t *debouncer) {
-    typename _KeyScannerProps::RowState delta, changes;
-
-    // Use xor to detect changes from last stable state:
-    // if a key has changed, it's bit will be 1, otherwise 0
-    delta = sample ^ debouncer->debounced_state;
-
-    // Increment counters and reset any unchanged bits:
-    // increment bit 1 for all changed keys
-    debouncer->db1 = ((debouncer->db1) ^ (debouncer->db0)) & delta;
-    // increment bit 0 for all changed keys
-    debouncer->db0 = ~(debouncer->db0) & delta;
-
-    // Calculate returned change set: if delta is still true
-    // and the counter has wrapped back to 0, the key is changed.
-
-    changes = ~(~delta | (debouncer->db0) | (debouncer->db1));
-    // Update state: in this case use xor to flip any bit that is true in changes.
-    debouncer->debounced_state ^= changes;
+  static constexpr uint16_t row_settle_cycles =
+    (uint32_t(_KeyScannerProps::column_settle_ns) * (F_CPU / 1000000) + 999) / 1000 + 1;
 
-    return changes;
+  typename _KeyScannerProps::RowState readCols() {
+    return ColumnReader<_KeyScannerProps, ATmegaPinRegister>::read();
   }
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
@@ -23,10 +23,12 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t
+#include <stdint.h>  // for uint8_t, uint32_t
 
-#include "kaleidoscope/MatrixAddr.h"  // IWYU pragma: keep
-#include "kaleidoscope/key_defs.h"    // for Key
+#include "kaleidoscope/MatrixAddr.h"                        // IWYU pragma: keep
+#include "kaleidoscope/driver/keyscanner/ChatterMonitor.h"  // for ChatterMonitor
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"        // for ScanRate
+#include "kaleidoscope/key_defs.h"                          // for Key
 
 // IWYU pragma: no_include "kaleidoscope/KeyAddr.h"
 
@@ -38,6 +40,15 @@ struct BaseProps {
   static constexpr uint8_t matrix_rows    = 0;
   static constexpr uint8_t matrix_columns = 0;
   typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
+
+  // A key that is pressed again less than this many milliseconds after it was
+  // released is counted as chattering. Zero leaves chatter monitoring out,
+  // along with the byte of RAM per key it needs, which is the default on AVR.
+#ifdef __AVR__
+  static constexpr uint8_t chatter_window_millis = 0;
+#else
+  static constexpr uint8_t chatter_window_millis = 20;
+#endif
 };
 
 template<typename _KeyScannerProps>
@@ -48,12 +59,36 @@ class Base {
   typedef typename _KeyScannerProps::KeyAddr KeyAddr;
 
   static void handleKeyswitchEvent(Key mappedKey, KeyAddr key_addr, uint8_t keyState);
+  // Scanners that know when they detected the change (as a `micros()` value)
+  // should pass it along as `timestamp`.
+  static void handleKeyswitchEvent(Key mappedKey, KeyAddr key_addr, uint8_t keyState, uint32_t timestamp);
+  // Events that don't come from a keyswitch (like encoder detents, which can
+  // come faster than any key chatters) go through this one instead, so that
+  // the chatter monitor doesn't count them.
+  static void handleInjectedKeyswitchEvent(KeyAddr key_addr, uint8_t keyState, uint32_t timestamp);
+  // Scanners that report several events at once can wrap them in these, so
+  // that their keyboard reports get coalesced where possible (see
+  // `Runtime_::beginReportBatch()`).
+  static void beginEventBatch();
+  static void endEventBatch();
 
   void setup() {}
   void readMatrix() {}
   void scanMatrix() {}
   void actOnMatrixScan() {}
 
+  /**
+   * Check if the next call to `scanMatrix()` may have anything to do.
+   *
+   * Scanners that read the matrix on a timer, or that queue up changes found
+   * by an interrupt handler, return `false` while there's nothing new, which
+   * allows the device to sleep between cycles. The default is to always
+   * return `true`, which means the device never sleeps.
+   */
+  bool scanPending() {
+    return true;
+  }
+
   uint8_t pressedKeyswitchCount() {
     return 0;
   }
@@ -67,6 +102,48 @@ class Base {
   bool wasKeyswitchPressed(KeyAddr key_addr) {
     return false;
   }
+
+  /**
+   * Chatter monitoring
+   *
+   * Every toggle-on and toggle-off event a scanner reports through
+   * `handleKeyswitchEvent()` (but not `handleInjectedKeyswitchEvent()`) is
+   * checked for chatter: a press that comes less than `chatterWindow()`
+   * milliseconds after the same key was released. The number of times each
+   * key chattered can be read with `chatterCount()`.
+   *
+   * With `setChatterRaisesDebounce(true)`, every chatter detected also calls
+   * `raiseDebounce()` for the key, which scanners with a per-key debounce
+   * policy implement by giving that key a longer debounce time.
+   *
+   * If the scanner's props have a `chatter_window_millis` of zero, there is no
+   * monitor: the window stays at zero, and all counts are zero.
+   */
+  static uint8_t chatterCount(KeyAddr key_addr);
+  static void resetChatterCounts();
+  static void setChatterWindow(uint8_t window);
+  static uint8_t chatterWindow();
+  static void setChatterRaisesDebounce(bool enabled);
+
+  void raiseDebounce(KeyAddr key_addr) {}
+
+  /**
+   * Adaptive scan rate
+   *
+   * Scanners that can slow down their matrix scans while no key is changing
+   * return their `ScanRate` here, through which the fast and slow intervals,
+   * and the time it takes to decay from one to the other, can be changed at
+   * runtime. Scanners with a fixed scan rate return `nullptr`.
+   */
+  ScanRate *scanRate() {
+    return nullptr;
+  }
+
+ private:
+  typedef ChatterMonitor<_KeyScannerProps::chatter_window_millis != 0 ? KeyAddr::upper_limit : 0>
+    ChatterMonitorType;
+
+  static ChatterMonitorType chatter_monitor_;
 };
 
 }  // namespace keyscanner
@@ -23,14 +23,15 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t
+#include <stdint.h>  // for uint8_t, uint32_t
 
-#include "kaleidoscope/KeyEvent.h"                // for KeyEvent
-#include "kaleidoscope/Runtime.h"                 // for Runtime, Runtime_
-#include "kaleidoscope/device/device.h"           // for Device
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for Base
-#include "kaleidoscope/key_defs.h"                // for Key
-#include "kaleidoscope/keyswitch_state.h"         // for keyToggledOff, keyToggledOn
+#include "kaleidoscope/KeyEvent.h"                          // for KeyEvent
+#include "kaleidoscope/Runtime.h"                           // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"                     // for Device
+#include "kaleidoscope/driver/keyscanner/Base.h"            // for Base
+#include "kaleidoscope/driver/keyscanner/ChatterMonitor.h"  // for ChatterMonitor
+#include "kaleidoscope/key_defs.h"                          // for Key
+#include "kaleidoscope/keyswitch_state.h"                   // for keyToggledOff, keyToggledOn
 
 namespace kaleidoscope {
 namespace driver {
@@ -40,18 +41,84 @@ template<>
 void Base<kaleidoscope::Device::Props::KeyScannerProps>::handleKeyswitchEvent(
   Key key __attribute__((unused)),
   kaleidoscope::Device::Props::KeyScannerProps::KeyAddr key_addr,
-  uint8_t key_state) {
+  uint8_t key_state,
+  uint32_t timestamp) {
 
   // Because the `KeyEvent` constructor invoked below assigns a new `EventId`
   // each time it's called, and plugins that implement `onKeyswitchEvent()` and
   // use those event ID numbers to determine whether or not an event is new,
   // it's critical that we do the test for keyswitches toggling on or off first.
   if (keyToggledOn(key_state) || keyToggledOff(key_state)) {
-    auto event = KeyEvent::next(key_addr, key_state);
+    if (chatter_monitor_.update(key_addr.toInt(), key_state, Runtime.millisAtCycleStart()) &&
+        chatter_monitor_.raiseDebounce())
+      Runtime.device().keyScanner().raiseDebounce(key_addr);
+
+    auto event = KeyEvent::next(key_addr, key_state, timestamp);
+    kaleidoscope::Runtime.handleKeyswitchEvent(event);
+  }
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::handleKeyswitchEvent(
+  Key key,
+  kaleidoscope::Device::Props::KeyScannerProps::KeyAddr key_addr,
+  uint8_t key_state) {
+  handleKeyswitchEvent(key, key_addr, key_state, 0);
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::handleInjectedKeyswitchEvent(
+  kaleidoscope::Device::Props::KeyScannerProps::KeyAddr key_addr,
+  uint8_t key_state,
+  uint32_t timestamp) {
+
+  if (keyToggledOn(key_state) || keyToggledOff(key_state)) {
+    auto event = KeyEvent::next(key_addr, key_state, timestamp);
     kaleidoscope::Runtime.handleKeyswitchEvent(event);
   }
 }
 
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::beginEventBatch() {
+  kaleidoscope::Runtime.beginReportBatch();
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::endEventBatch() {
+  kaleidoscope::Runtime.endReportBatch();
+}
+
+template<>
+Base<kaleidoscope::Device::Props::KeyScannerProps>::ChatterMonitorType
+  Base<kaleidoscope::Device::Props::KeyScannerProps>::chatter_monitor_(
+    kaleidoscope::Device::Props::KeyScannerProps::chatter_window_millis);
+
+template<>
+uint8_t Base<kaleidoscope::Device::Props::KeyScannerProps>::chatterCount(
+  kaleidoscope::Device::Props::KeyScannerProps::KeyAddr key_addr) {
+  return chatter_monitor_.count(key_addr.toInt());
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::resetChatterCounts() {
+  chatter_monitor_.reset();
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::setChatterWindow(uint8_t window) {
+  chatter_monitor_.setWindow(window);
+}
+
+template<>
+uint8_t Base<kaleidoscope::Device::Props::KeyScannerProps>::chatterWindow() {
+  return chatter_monitor_.window();
+}
+
+template<>
+void Base<kaleidoscope::Device::Props::KeyScannerProps>::setChatterRaisesDebounce(bool enabled) {
+  chatter_monitor_.setRaiseDebounce(enabled);
+}
+
 }  // namespace keyscanner
 }  // namespace driver
 }  // namespace kaleidoscope
@@ -0,0 +1,150 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t
+
+#include "kaleidoscope/keyswitch_state.h"  // for keyToggledOff, keyToggledOn
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Counts keyswitch chatter that gets past the debouncer
+ *
+ * A key that is pressed again within a few milliseconds of being released
+ * wasn't pressed twice by a human: its switch is chattering, and the host sees
+ * a doubled keystroke. The monitor watches the debounced events of all keys,
+ * and counts these suspiciously short release/press pairs for each of them,
+ * so that worn switches can be found without running the (blocking) hardware
+ * test mode.
+ *
+ * Only the last few releases are remembered, rather than one timestamp per
+ * key, so this takes one byte of RAM per key (for the counter) plus a dozen.
+ * A window of zero disables the monitor. A `_key_count` of zero leaves it out
+ * altogether (see the specialisation below), for key scanners whose props
+ * don't ask for it.
+ */
+template<uint8_t _key_count>
+class ChatterMonitor {
+ public:
+  explicit ChatterMonitor(uint8_t window)
+    : window_(window) {}
+
+  void setWindow(uint8_t window) {
+    window_ = window;
+  }
+  uint8_t window() const {
+    return window_;
+  }
+
+  void setRaiseDebounce(bool enabled) {
+    raise_debounce_ = enabled;
+  }
+  bool raiseDebounce() const {
+    return raise_debounce_;
+  }
+
+  /// The number of times the key was caught chattering, up to 255.
+  uint8_t count(uint8_t key_index) const {
+    return counts_[key_index];
+  }
+
+  void reset() {
+    for (uint8_t &count : counts_)
+      count = 0;
+  }
+
+  /// Record a debounced event of the key at `key_index`, at time `now` (in
+  /// milliseconds). Returns `true` if it is a press that comes too soon after
+  /// the key's last release.
+  bool update(uint8_t key_index, uint8_t key_state, uint16_t now) {
+    if (window_ == 0)
+      return false;
+
+    if (keyToggledOff(key_state)) {
+      releases_[next_release_] = Release{uint8_t(key_index + 1), now};
+      next_release_            = (next_release_ + 1) % release_slots;
+      return false;
+    }
+    if (!keyToggledOn(key_state))
+      return false;
+
+    for (Release &release : releases_) {
+      if (release.key != key_index + 1)
+        continue;
+      release.key = 0;
+      if (uint16_t(now - release.time) >= window_)
+        return false;
+      if (counts_[key_index] < UINT8_MAX)
+        ++counts_[key_index];
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  static constexpr uint8_t release_slots = 4;
+
+  struct Release {
+    uint8_t key;  // key index + 1, so that zero is an empty slot
+    uint16_t time;
+  };
+
+  uint8_t window_;
+  bool raise_debounce_ = false;
+  uint8_t next_release_ = 0;
+  Release releases_[release_slots] = {};
+  uint8_t counts_[_key_count] = {};
+};
+
+// A monitor that is always disabled, and takes no RAM.
+template<>
+class ChatterMonitor<0> {
+ public:
+  explicit ChatterMonitor(uint8_t) {}
+
+  void setWindow(uint8_t) {}
+  uint8_t window() const {
+    return 0;
+  }
+
+  void setRaiseDebounce(bool) {}
+  bool raiseDebounce() const {
+    return false;
+  }
+
+  uint8_t count(uint8_t) const {
+    return 0;
+  }
+
+  void reset() {}
+
+  bool update(uint8_t, uint8_t, uint16_t) {
+    return false;
+  }
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,124 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/device/avr/pins_and_ports.h"  // for PORT_SHIFTER, PIN_ADDRESS_MASK
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Reads the matrix columns of an AVR key scanner, one port at a time
+ *
+ * The column pins in `_Props::matrix_col_pins` are encoded with `PINDEF()`,
+ * that is, as the address of their port's `PINx` register and their bit in it.
+ * Instead of reading each column pin on its own, `read()` reads every port
+ * that has any columns on it exactly once, and then moves the bits of those
+ * columns into place. All of this is worked out at compile time, and unrolled
+ * through templates, so what's left is one register read per port, and a
+ * test-and-set of a constant bit per column.
+ *
+ * `_PinRegister` provides the register reads: a class with a static
+ * `read<port>()` function that returns the value of that port's `PINx`
+ * register. The `ATmega` key scanner reads the actual registers, while tests
+ * can substitute a fake one.
+ */
+template<typename _Props, typename _PinRegister>
+class ColumnReader {
+ public:
+  typedef typename _Props::RowState RowState;
+
+  /// Returns the state of the columns, with the bits of the ones that are
+  /// pulled low set.
+  static RowState read() {
+    return Ports<0>::read();
+  }
+
+  /// The number of port registers `read()` reads, as opposed to the number of
+  /// columns, which is what reading them pin by pin takes.
+  static constexpr uint8_t portReads(uint8_t port = 0) {
+    return port == port_limit ? 0 : uint8_t(portUsed(port)) + portReads(port + 1);
+  }
+
+ private:
+  static constexpr uint8_t columns    = _Props::matrix_columns;
+  static constexpr uint8_t port_limit = 1 << (8 - PORT_SHIFTER);
+
+  static constexpr uint8_t portOf(uint8_t col) {
+    return _Props::matrix_col_pins[col] >> PORT_SHIFTER;
+  }
+  static constexpr uint8_t maskOf(uint8_t col) {
+    return 1 << (_Props::matrix_col_pins[col] & PIN_ADDRESS_MASK);
+  }
+  static constexpr bool portUsed(uint8_t port, uint8_t col = 0) {
+    return col < columns && (portOf(col) == port || portUsed(port, col + 1));
+  }
+
+  // Collects the bits of the columns on `_port`, given the (inverted) value
+  // of its register.
+  template<uint8_t _port, uint8_t _col = 0, bool _done = (_col == columns)>
+  struct Gather {
+    static constexpr bool on_port = portOf(_col) == _port;
+    static constexpr uint8_t mask = maskOf(_col);
+    static constexpr RowState bit = RowState(1) << _col;
+
+    static RowState from(uint8_t pins) {
+      RowState hot_pins = Gather<_port, _col + 1>::from(pins);
+      if (on_port && (pins & mask))
+        hot_pins |= bit;
+      return hot_pins;
+    }
+  };
+  template<uint8_t _port, uint8_t _col>
+  struct Gather<_port, _col, true> {
+    static RowState from(uint8_t) {
+      return 0;
+    }
+  };
+
+  template<uint8_t _port, bool _used = portUsed(_port), bool _done = (_port == port_limit)>
+  struct Ports {
+    static RowState read() {
+      uint8_t pins = ~_PinRegister::template read<_port>();
+      return Gather<_port>::from(pins) | Ports<_port + 1>::read();
+    }
+  };
+  template<uint8_t _port>
+  struct Ports<_port, false, false> {
+    static RowState read() {
+      return Ports<_port + 1>::read();
+    }
+  };
+  template<uint8_t _port, bool _used>
+  struct Ports<_port, _used, true> {
+    static RowState read() {
+      return 0;
+    }
+  };
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
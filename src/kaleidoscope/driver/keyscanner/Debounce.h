@@ -0,0 +1,304 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Debounce policies for matrix key scanners
+ *
+ * A key scanner keeps one debouncer per matrix row, and feeds it the raw state
+ * of that row (one bit per column, set while the key is pressed) every time it
+ * reads the matrix. `debounce()` returns the bits of the keys whose debounced
+ * state changed with that sample, and `state()` returns the debounced state of
+ * the whole row. `penalize()` asks for a longer debounce time for one key,
+ * because it was caught chattering, and returns `false` if the policy can't do
+ * that.
+ *
+ * All policies count matrix scans rather than time, so the time they take to
+ * settle depends on the scanner's scan interval. The scanner picks its policy
+ * through the `Debouncer` type in its props, which must use the same `RowState`
+ * type as the props themselves:
+ *
+ *   struct MyKeyScannerProps : public ATmegaProps {
+ *     ...
+ *     typedef debounce::EagerPress<RowState> Debouncer;
+ *   };
+ */
+namespace debounce {
+
+/* No debouncing at all: every sample is taken at face value.
+ *
+ * Useful for scanners whose hardware (or a separate controller) has already
+ * debounced the matrix.
+ */
+template<typename _RowState>
+class None {
+ public:
+  typedef _RowState RowState;
+
+  RowState debounce(RowState sample) {
+    RowState changes = sample ^ state_;
+    state_           = sample;
+    return changes;
+  }
+
+  RowState state() const {
+    return state_;
+  }
+
+  bool penalize(uint8_t col) {
+    return false;
+  }
+
+ private:
+  RowState state_ = 0;
+};
+
+/* Symmetric delayed debouncing, for both presses and releases.
+ *
+ * A key has to read the same for four scans in a row before its new state is
+ * accepted. This is the most resistant to chatter and electrical noise, but it
+ * delays every press and every release by four scans.
+ *
+ * Each key has a two-bit counter, stored "vertically": bit 0 of the counters
+ * of all keys in the row is in `db0_`, and bit 1 is in `db1_`, so the whole
+ * row is updated with a handful of bitwise operations.
+ */
+template<typename _RowState>
+class Symmetric {
+ public:
+  typedef _RowState RowState;
+
+  RowState debounce(RowState sample) {
+    RowState delta, changes;
+
+    // Use xor to detect changes from last stable state:
+    // if a key has changed, it's bit will be 1, otherwise 0
+    delta = sample ^ state_;
+
+    // Increment counters and reset any unchanged bits:
+    // increment bit 1 for all changed keys
+    db1_ = (db1_ ^ db0_) & delta;
+    // increment bit 0 for all changed keys
+    db0_ = ~db0_ & delta;
+
+    // Calculate returned change set: if delta is still true
+    // and the counter has wrapped back to 0, the key is changed.
+    changes = ~(~delta | db0_ | db1_);
+
+    // Update state: in this case use xor to flip any bit that is true in changes.
+    state_ ^= changes;
+
+    return changes;
+  }
+
+  RowState state() const {
+    return state_;
+  }
+
+  bool penalize(uint8_t col) {
+    return false;
+  }
+
+ private:
+  RowState db0_   = 0;  // counter bit 0
+  RowState db1_   = 0;  // counter bit 1
+  RowState state_ = 0;  // debounced state
+};
+
+/* Eager debouncing for presses, delayed debouncing for releases.
+ *
+ * A press is reported as soon as the key is first read as pressed, so it's
+ * four scans faster than with `Symmetric`. Contact bounce while the key is
+ * held is ignored, because a release has to read the same for four scans in a
+ * row before it is accepted. After a release, the key is locked out for three
+ * more scans, so that bounce while it comes back up can't be mistaken for a
+ * new press.
+ *
+ * This relies on the matrix being free of noise while keys are idle: a single
+ * bad read of a released key becomes a keypress.
+ */
+template<typename _RowState>
+class EagerPress {
+ public:
+  typedef _RowState RowState;
+
+  RowState debounce(RowState sample) {
+    RowState delta  = sample ^ state_;
+    RowState locked = lk0_ | lk1_;
+
+    // Presses of keys that aren't locked out go through immediately.
+    RowState presses = delta & sample & ~locked;
+
+    // Releases use the same vertical counters as `Symmetric`, and the
+    // counters of keys that read as pressed again are reset.
+    RowState released = delta & ~sample;
+    db1_              = (db1_ ^ db0_) & released;
+    db0_              = ~db0_ & released;
+    RowState releases = released & ~db0_ & ~db1_;
+
+    // Count down the lockouts, then start them for the keys that were just
+    // released: 3, 2, 1, 0.
+    RowState lk1 = lk1_ & lk0_;
+    lk0_         = ~lk0_ & lk1_;
+    lk1_         = lk1 | releases;
+    lk0_ |= releases;
+
+    RowState changes = presses | releases;
+    state_ ^= changes;
+    return changes;
+  }
+
+  RowState state() const {
+    return state_;
+  }
+
+  bool penalize(uint8_t col) {
+    return false;
+  }
+
+ private:
+  RowState db0_   = 0;  // release counter bit 0
+  RowState db1_   = 0;  // release counter bit 1
+  RowState lk0_   = 0;  // lockout counter bit 0
+  RowState lk1_   = 0;  // lockout counter bit 1
+  RowState state_ = 0;  // debounced state
+};
+
+/* Delayed debouncing with a separate, self-adjusting threshold for each key.
+ *
+ * A key's new state is accepted once it has read the same for as many scans as
+ * the key's threshold, which starts out at `_min_scans`. Whenever a key reads
+ * differently from its debounced state, but goes back before that change is
+ * accepted, the key is bouncing, and its threshold is raised by one scan, up to
+ * `_max_scans`. Every change that is accepted without any bounce lowers it by
+ * one again. That way, keys with clean switches get by with the minimum delay,
+ * and only worn or noisy switches pay for the extra chatter immunity.
+ * With `_min_scans` equal to `_max_scans`, this is a plain per-key counter.
+ *
+ * Keys that get through the debouncer and chatter anyway can be `penalize()`d,
+ * which raises their lowest threshold by one scan for good (until the next
+ * reset), so that they can't adjust back down to where they chattered.
+ *
+ * This uses two bytes of RAM per key, so it's a better fit for boards with more
+ * RAM to spare than the ATmega32U4.
+ */
+template<typename _RowState, uint8_t _min_scans = 2, uint8_t _max_scans = 8>
+class Adaptive {
+ public:
+  typedef _RowState RowState;
+
+  static_assert(_min_scans > 0 && _min_scans <= _max_scans && _max_scans <= 15,
+                "Adaptive debouncing needs 0 < _min_scans <= _max_scans <= 15");
+
+  RowState debounce(RowState sample) {
+    RowState delta   = sample ^ state_;
+    RowState changes = 0;
+
+    // Keys that have a partial count, but now read the same as their
+    // debounced state again, bounced.
+    RowState bounced = pending_ & ~delta;
+    bounced_ |= bounced;
+    pending_ &= delta;
+
+    for (uint8_t col = 0; (delta | bounced) != 0; col++, delta >>= 1, bounced >>= 1) {
+      Key &key = keys_[col];
+      if (bounced & 1) {
+        key.count = 0;
+        if (threshold(key) < _max_scans)
+          key.threshold = threshold(key) + 1;
+      }
+      if (!(delta & 1))
+        continue;
+
+      RowState bit = RowState(1) << col;
+      if (++key.count < threshold(key)) {
+        pending_ |= bit;
+        continue;
+      }
+
+      key.count = 0;
+      pending_ &= ~bit;
+      if (bounced_ & bit) {
+        bounced_ &= ~bit;
+      } else if (key.threshold > lowest(key)) {
+        --key.threshold;
+      }
+      changes |= bit;
+    }
+
+    state_ ^= changes;
+    return changes;
+  }
+
+  RowState state() const {
+    return state_;
+  }
+
+  bool penalize(uint8_t col) {
+    Key &key = keys_[col];
+    if (lowest(key) >= _max_scans)
+      return false;
+    key.floor = lowest(key) + 1;
+    if (key.threshold < key.floor)
+      key.threshold = key.floor;
+    return true;
+  }
+
+  /// The current threshold (in scans) of the key in column `col`.
+  uint8_t threshold(uint8_t col) const {
+    return threshold(keys_[col]);
+  }
+
+ private:
+  struct Key {
+    uint8_t count;
+    // Zero (as in a freshly zeroed static array) stands for `_min_scans`, in
+    // both of these.
+    uint8_t threshold : 4;
+    uint8_t floor : 4;
+  };
+
+  // The lowest the key's threshold can go: `_min_scans`, unless the key has
+  // been penalized.
+  static uint8_t lowest(const Key &key) {
+    return key.floor < _min_scans ? _min_scans : key.floor;
+  }
+  static uint8_t threshold(const Key &key) {
+    return key.threshold < lowest(key) ? lowest(key) : key.threshold;
+  }
+
+  Key keys_[sizeof(RowState) * 8] = {};
+  RowState pending_ = 0;  // keys with a partial count
+  RowState bounced_ = 0;  // keys that bounced since their last change
+  RowState state_   = 0;  // debounced state
+};
+
+}  // namespace debounce
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,94 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for int32_t, uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* A batch of key scanner events, drained from a queue in one go
+ *
+ * Scanners that find key changes in an interrupt handler, and queue them up
+ * for the main loop, can use this to take all of the queued events at once,
+ * rather than handling them one by one as they come out of the queue. The
+ * events are put in the order they were detected in, by their `timestamp`
+ * member (a `micros()` value), so that changes found in different scans (or
+ * queued by other code, such as encoders) don't get reordered.
+ *
+ * The queue itself is not part of the batch: `drain()` takes a function that
+ * moves one event from the queue into its argument, and returns `false` once
+ * the queue is empty. That way, the same code works with a FreeRTOS queue on
+ * the device, and with a plain container in host tests.
+ */
+template<typename _Event, uint8_t _capacity>
+class EventBatch {
+ public:
+  /// Move up to `_capacity` events out of the queue, and sort them by the
+  /// time they were detected. Returns the number of events in the batch.
+  template<typename _Receive>
+  uint8_t drain(_Receive receive) {
+    size_ = 0;
+    while (size_ < _capacity && receive(events_[size_]))
+      ++size_;
+    sortByTimestamp();
+    return size_;
+  }
+
+  uint8_t size() const {
+    return size_;
+  }
+  const _Event &operator[](uint8_t index) const {
+    return events_[index];
+  }
+  const _Event *begin() const {
+    return events_;
+  }
+  const _Event *end() const {
+    return events_ + size_;
+  }
+
+ private:
+  // The events mostly come out of the queue in order already, so a (stable)
+  // insertion sort only has to move the odd one. Timestamps are compared as a
+  // signed difference, so that this still works when `micros()` wraps around.
+  void sortByTimestamp() {
+    for (uint8_t i = 1; i < size_; i++) {
+      _Event event = events_[i];
+      uint8_t j    = i;
+      while (j > 0 && int32_t(events_[j - 1].timestamp - event.timestamp) > 0) {
+        events_[j] = events_[j - 1];
+        --j;
+      }
+      events_[j] = event;
+    }
+  }
+
+  _Event events_[_capacity];
+  uint8_t size_ = 0;
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,102 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Ghost key suppression for matrices without diodes
+ *
+ * In a matrix without a diode on every key, pressing three corners of a
+ * rectangle (two keys in one row, and a third in one of their columns) also
+ * connects the fourth corner, and the scan shows it as pressed. From the scan
+ * alone, there is no telling which of the four keys is the ghost, so any two
+ * rows that have two or more pressed columns in common make all of those keys
+ * ambiguous.
+ *
+ * `GhostFilter` finds them by comparing the row bitmaps pairwise, without
+ * looking at individual keys, and `filter()` keeps ambiguous keys in whatever
+ * state they were last accepted in. Keys pressed one after the other are thus
+ * still reported as they go down, but the key that completes a rectangle is
+ * held back until the rectangle is broken up again.
+ *
+ * Key scanners that support it enable it with `ghost_detection` in their
+ * props, and run it over the full, debounced matrix before accepting it:
+ *
+ *   GhostFilter<RowState, matrix_rows> ghosts;
+ *   ghosts.detect([](uint8_t row) { return debounced(row); });
+ *   for (uint8_t row = 0; row < matrix_rows; row++)
+ *     current[row] = ghosts.filter(row, debounced(row), current[row]);
+ */
+template<typename _RowState, uint8_t _rows>
+class GhostFilter {
+ public:
+  /// Finds the ambiguous keys in the matrix given by `scanned`, a function
+  /// that returns the state of a row.
+  template<typename _Scanned>
+  void detect(_Scanned scanned) {
+    _RowState rows[_rows];  // NOLINT(runtime/arrays)
+    for (uint8_t row = 0; row < _rows; row++) {
+      rows[row]       = scanned(row);
+      ambiguous_[row] = 0;
+    }
+
+    for (uint8_t row = 0; row < _rows; row++) {
+      // A row with fewer than two keys pressed can't share two of them.
+      if (!hasTwoOrMore(rows[row]))
+        continue;
+      for (uint8_t other = row + 1; other < _rows; other++) {
+        _RowState shared = rows[row] & rows[other];
+        if (hasTwoOrMore(shared)) {
+          ambiguous_[row] |= shared;
+          ambiguous_[other] |= shared;
+        }
+      }
+    }
+  }
+
+  /// The state to accept for `row`: the `scanned` state, except for the
+  /// ambiguous keys, which keep their `accepted` state.
+  _RowState filter(uint8_t row, _RowState scanned, _RowState accepted) const {
+    return (scanned & ~ambiguous_[row]) | (accepted & ambiguous_[row]);
+  }
+
+  /// The keys of `row` that were found to be ambiguous.
+  _RowState ambiguous(uint8_t row) const {
+    return ambiguous_[row];
+  }
+
+ private:
+  static bool hasTwoOrMore(_RowState keys) {
+    return (keys & (keys - 1)) != 0;
+  }
+
+  _RowState ambiguous_[_rows];  // NOLINT(runtime/arrays)
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,83 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint16_t, uint32_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Decides when a matrix key scanner can stop scanning row by row
+ *
+ * While the matrix is idle, a scanner can drive all of its rows at once, and
+ * then a single look at the columns (or a pin change interrupt on them) tells
+ * it whether any key has been pressed. The scanner reports after every full
+ * scan whether the matrix was quiet: no key reads as pressed, and the
+ * debouncer has nothing left to settle. Once it has been quiet for the idle
+ * timeout, `update()` tells the scanner to go idle, and the scanner calls
+ * `wake()` when it sees a key again.
+ *
+ * A timeout of zero (the default) disables idling.
+ */
+class IdleTracker {
+ public:
+  void setTimeout(uint16_t timeout) {
+    timeout_ = timeout;
+  }
+  uint16_t timeout() const {
+    return timeout_;
+  }
+
+  bool isIdle() const {
+    return idle_;
+  }
+
+  /// Record the result of a full matrix scan, made at time `now` (in
+  /// milliseconds). Returns `true` if the scanner should go idle now.
+  bool update(bool quiet, uint32_t now) {
+    if (!quiet || timeout_ == 0) {
+      last_activity_ = now;
+      return false;
+    }
+    if (now - last_activity_ < timeout_)
+      return false;
+    idle_ = true;
+    return true;
+  }
+
+  /// Leave the idle state, and restart the timeout from `now`.
+  void wake(uint32_t now) {
+    idle_          = false;
+    last_activity_ = now;
+  }
+
+ private:
+  uint32_t last_activity_ = 0;
+  uint16_t timeout_       = 0;
+  bool idle_              = false;
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
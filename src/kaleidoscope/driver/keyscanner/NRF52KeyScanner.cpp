@@ -31,6 +31,8 @@ namespace keyscanner {
 // Initialize static pointer to active scanner
 TimerHandlerInterface *active_scanner_ = nullptr;
 
+constexpr uint8_t NRF52KeyScannerProps::idle_sense_pins[];
+
 }  // namespace keyscanner
 }  // namespace driver
 }  // namespace kaleidoscope
@@ -24,6 +24,10 @@
 
 #ifdef ARDUINO_ARCH_NRF52
 #include "kaleidoscope/driver/keyscanner/Base.h"
+#include "kaleidoscope/driver/keyscanner/Debounce.h"
+#include "kaleidoscope/driver/keyscanner/EventBatch.h"
+#include "kaleidoscope/driver/keyscanner/IdleTracker.h"
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"
 #include "kaleidoscope/keyswitch_state.h"
 #include "FreeRTOS.h"
 #include "queue.h"
@@ -39,9 +43,45 @@ struct NRF52KeyScannerProps : kaleidoscope::driver::keyscanner::BaseProps {
   /// @brief Interval between key matrix scans in microseconds
   static constexpr uint32_t keyscan_interval_micros = 1500;
 
+  /// @brief Interval between key matrix scans while no key is changing, in microseconds
+  /// When this is longer than `keyscan_interval_micros`, the scanner only
+  /// scans at that rate while keys are changing, and slows down to this one
+  /// once they haven't for a while (see `ScanRate`). Zero keeps the rate fixed.
+  static constexpr uint16_t keyscan_slow_interval_micros = 0;
+
+  /// @brief Time it takes the scan interval to double once no key is changing, in milliseconds
+  static constexpr uint16_t keyscan_decay_millis = 50;
+
+  /// @brief Time to wait after driving a row low before reading the columns
+  /// This depends on the board's pull-ups and trace capacitance, so boards
+  /// with a fast matrix can lower it to shorten the scan.
+  static constexpr uint32_t row_settle_micros = 10;
+
   /// @brief Type used to store the state of a matrix row
   typedef uint16_t RowState;
 
+  /// @brief Debounce policy, one per matrix row
+  /// The default is a per-key counter of three scans. Boards that change
+  /// `RowState` need to change this to match.
+  typedef debounce::Adaptive<RowState, 3, 3> Debouncer;
+
+  /// @brief Time the matrix has to be quiet before the scanner goes idle, in milliseconds
+  /// While idle, the scan timer is stopped, all rows are driven low, and a
+  /// keypress restarts the timer through the GPIO sense mechanism. Zero
+  /// disables idling.
+  static constexpr uint16_t idle_timeout_millis = 0;
+
+  /// @brief Other pins that may have low level sensing enabled while awake
+  /// A sensed pin that is already low holds the shared DETECT signal high, and
+  /// then no keypress raises a PORT event, so the scanner would never wake.
+  /// While idle, each of these pins that is sensed senses the level it isn't
+  /// at instead, so that it wakes the scanner when it changes. Boards that
+  /// sense encoder pins, for instance, need to list them here.
+  static constexpr uint8_t idle_sense_pins[] = {};
+
+  /// @brief PPI channel used to restart the scan timer when a key is pressed while idle
+  static constexpr uint8_t idle_wake_ppi_channel = 1;
+
   /*
    * The following two arrays must be shadowed by the descendant keyscanner
    * description class to define the actual matrix pins.
@@ -73,11 +113,14 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
  private:
   typedef NRF52KeyScanner<_Props> ThisType;
 
-  // Packed event structure to minimize queue memory usage
+  // An event waiting in the queue: the key's position and state, packed into
+  // a byte, and the time it was detected at.
   struct Event {
     uint8_t row : 4;
     uint8_t col : 4;
     bool pressed : 1;
+    bool injected : 1;   // queued by `queueKeyEvent()`, not the matrix scan
+    uint32_t timestamp;  // micros() when the change was queued
   };
 
   // Static queue storage and control structures
@@ -85,6 +128,10 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
   static StaticQueue_t event_queue_buffer_;
   static uint8_t event_queue_storage_[EVENT_QUEUE_SIZE * sizeof(Event)];
   static QueueHandle_t event_queue_handle_;
+  // The events being handled by the current `scanMatrix()`
+  static EventBatch<Event, EVENT_QUEUE_SIZE> event_batch_;
+  // The number of times an event didn't fit in the queue
+  static uint16_t queue_overflows_;
 
  protected:
   struct row_state_t {
@@ -130,7 +177,26 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
   /// This is used by both matrix scanning and external code (like encoders)
   /// @return true if event was queued, false if queue was full
   bool queueKeyEvent(uint8_t row, uint8_t col, bool state) {
-    Event event                           = {row, col, state};
+    bool queued = sendToEventQueue(row, col, state, true);
+    if (!queued)
+      countQueueOverflow();
+    return queued;
+  }
+
+  /// @brief The number of times an event didn't fit in the event queue
+  /// Changes found by the matrix scan are retried on the next scan, so they
+  /// are only delayed, and each of them is counted once, however many scans
+  /// it takes. Events queued by other code (like encoders) are lost. A count
+  /// that keeps growing means that the main loop can't keep up.
+  uint16_t queueOverflowCount() const {
+    return queue_overflows_;
+  }
+
+ private:
+  static bool sendToEventQueue(uint8_t row, uint8_t col, bool state, bool injected = false) {
+    // Events can sit in the queue for a while before the main loop gets to
+    // them, so we record when they were detected, for timing-sensitive plugins.
+    Event event                           = {row, col, state, injected, micros()};
     BaseType_t higher_priority_task_woken = pdFALSE;
 
     // Use ISR version since this might be called from interrupt context
@@ -145,7 +211,12 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     return success == pdTRUE;
   }
 
+  static void countQueueOverflow() {
+    if (queue_overflows_ < UINT16_MAX)
+      ++queue_overflows_;
+  }
 
+ public:
   /// @brief Suspend the timer interrupt used for matrix scanning
   void suspendTimer() {
     // Stop the timer
@@ -181,16 +252,20 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     for (uint8_t i = 0; i < _Props::matrix_rows; i++) {
       pinMode(_Props::matrix_row_pins[i], OUTPUT);
       digitalWrite(_Props::matrix_row_pins[i], HIGH);
+      row_ports_[i] = gpioPort(_Props::matrix_row_pins[i]);
+      row_masks_[i] = gpioMask(_Props::matrix_row_pins[i]);
     }
     for (uint8_t i = 0; i < _Props::matrix_columns; i++) {
       pinMode(_Props::matrix_col_pins[i], INPUT_PULLUP);
+      col_ports_[i] = g_ADigitalPinMap[_Props::matrix_col_pins[i]] >= 32 ? 1 : 0;
+      col_masks_[i] = gpioMask(_Props::matrix_col_pins[i]);
     }
 
     // Configure hardware timer for scanning
     NRF_TIMER1->MODE      = TIMER_MODE_MODE_Timer;            // Set timer mode
     NRF_TIMER1->BITMODE   = TIMER_BITMODE_BITMODE_32Bit;      // 32-bit timer
     NRF_TIMER1->PRESCALER = 5;                                // 1 MHz, to get our interval in microseconds
-    NRF_TIMER1->CC[0]     = _Props::keyscan_interval_micros;  // Set compare value
+    NRF_TIMER1->CC[0]     = _Props::keyscan_interval_micros;  // Set compare value, the fast rate
     NRF_TIMER1->SHORTS    = TIMER_SHORTS_COMPARE0_CLEAR_Msk;  // Auto clear on compare match
     NRF_TIMER1->INTENSET  = TIMER_INTENSET_COMPARE0_Msk;      // Enable compare interrupt
 
@@ -199,8 +274,21 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     NVIC_ClearPendingIRQ(TIMER1_IRQn);
     NVIC_EnableIRQ(TIMER1_IRQn);
 
+    scan_rate_.setFastInterval(_Props::keyscan_interval_micros);
+    scan_rate_.setSlowInterval(_Props::keyscan_slow_interval_micros);
+    scan_rate_.setDecay(_Props::keyscan_decay_millis);
+    scan_rate_.update(true, millis());
+
     // Start timer
     NRF_TIMER1->TASKS_START = 1;
+
+    setIdleTimeout(_Props::idle_timeout_millis);
+  }
+
+  /// @brief Set how long the matrix has to be quiet before the scanner goes idle
+  /// @param timeout Time in milliseconds, or zero to disable idling
+  void setIdleTimeout(uint16_t timeout) {
+    idle_tracker_.setTimeout(timeout);
   }
 
   void readMatrix() {
@@ -212,22 +300,26 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
   }
 
   /// @brief Process any buffered events and update matrix state
+  /// All the events queued since the last call are taken out of the queue at
+  /// once, and handled in the order they were detected in. Each one is acted
+  /// on directly, instead of looking for changes in the whole matrix, and their
+  /// keyboard reports are coalesced where the host can't tell the difference
+  /// (see `Runtime_::beginReportBatch()`).
   void scanMatrix() {
-    Event event;
-
-    // Process any buffered events
-    while (xQueueReceive(event_queue_handle_, &event, 0) == pdTRUE) {
-      // Update matrix state with latest event
-      applyQueuedEvent(event);
-
-      // It's possible to have multiple events for the same key in the queue.
-      // so we need to act on the matrix scan for each and every event.
-      // Process any state changes
-      actOnMatrixScan();
-
-      // Update previous state for next scan
-      updateMatrixScanKeyState();
-    }
+    uint8_t count = event_batch_.drain([](Event &event) {
+      return xQueueReceive(event_queue_handle_, &event, 0) == pdTRUE;
+    });
+    if (count == 0)
+      return;
+
+    ThisType::beginEventBatch();
+    for (const Event &event : event_batch_)
+      actOnQueuedEvent(event);
+
+    // Pick up any changes made with `setMatrixState()` rather than queued.
+    actOnMatrixScan();
+    updateMatrixScanKeyState();
+    ThisType::endEventBatch();
   }
 
   uint8_t pressedKeyswitchCount() {
@@ -248,6 +340,13 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     return uxQueueMessagesWaiting(event_queue_handle_) > 0;
   }
 
+  /// @brief Check if `scanMatrix()` has anything to do
+  /// The matrix is read by the timer handler, which only queues an event once
+  /// a change has been debounced, so there's nothing to do until it does.
+  bool scanPending() const {
+    return hasQueuedEvents();
+  }
+
   uint8_t previousPressedKeyswitchCount() {
     uint8_t count = 0;
     for (uint8_t r = 0; r < _Props::matrix_rows; r++) {
@@ -260,6 +359,41 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     return bitRead(matrix_state_[key_addr.row()].previous, key_addr.col());
   }
 
+  void raiseDebounce(KeyAddr key_addr) {
+    // The debouncers are run by the timer interrupt handler.
+    NVIC_DisableIRQ(TIMER1_IRQn);
+    debouncers_[key_addr.row()].penalize(key_addr.col());
+    NVIC_EnableIRQ(TIMER1_IRQn);
+  }
+
+  /// @brief The adaptive scan rate
+  /// The timer interrupt handler picks up changes made through this on its
+  /// next scan.
+  ScanRate *scanRate() {
+    return &scan_rate_;
+  }
+
+  /// @brief Apply a queued event to the matrix state, and act on it
+  /// It's possible to have multiple events for the same key in a batch, so
+  /// each one gets acted on before the next is applied.
+  void actOnQueuedEvent(const Event &event) {
+    applyQueuedEvent(event);
+
+    row_state_t &state = matrix_state_[event.row];
+    uint8_t keyState   = (bitRead(state.previous, event.col) << 0) |
+                         (bitRead(state.current, event.col) << 1);
+    if (event.injected) {
+      // Encoder detents toggle their key faster than any chatter window, so
+      // they're kept out of the chatter monitor.
+      ThisType::handleInjectedKeyswitchEvent(KeyAddr(event.row, event.col), keyState, event.timestamp);
+    } else if (keyToggledOn(keyState) || keyToggledOff(keyState)) {
+      ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(event.row, event.col), keyState, event.timestamp);
+    }
+
+    typename _Props::RowState bit = typename _Props::RowState(1) << event.col;
+    state.previous                = (state.previous & ~bit) | (state.current & bit);
+  }
+
   /// @brief Process any changes in the matrix state and generate key events
   void actOnMatrixScan() {
     // Process any state changes
@@ -278,31 +412,171 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
     }
   }
 
+  /// @brief Drive a row low and sample all of its columns at once
+  /// Instead of a `digitalRead()` per column, this reads the `IN` register of
+  /// each GPIO port once, and picks the column bits out of those, using the
+  /// port and mask that `setup()` computed for each column pin.
+  typename _Props::RowState readRow(uint8_t row) {
+    row_ports_[row]->OUTCLR = row_masks_[row];
+    delayMicroseconds(_Props::row_settle_micros);
+
+    uint32_t port_state[2];
+    port_state[0] = NRF_P0->IN;
+#ifdef NRF_P1
+    port_state[1] = NRF_P1->IN;
+#else
+    port_state[1] = 0;
+#endif
+
+    row_ports_[row]->OUTSET = row_masks_[row];
+
+    typename _Props::RowState hot_pins = 0;
+    for (uint8_t col = 0; col < _Props::matrix_columns; col++) {
+      if (!(port_state[col_ports_[col]] & col_masks_[col]))
+        hot_pins |= typename _Props::RowState(1) << col;
+    }
+    return hot_pins;
+  }
+
   // Timer handler interface implementation
   void handleTimer() override {
+    // While idle, the timer only runs again once a key has been pressed.
+    if (idle_tracker_.isIdle())
+      wakeMatrix();
+
+    typename _Props::RowState any_hot_pins = 0;
+    typename _Props::RowState any_pressed  = 0;
+    typename _Props::RowState any_changing = 0;
+
     for (uint8_t row = 0; row < _Props::matrix_rows; row++) {
-      digitalWrite(_Props::matrix_row_pins[row], LOW);
-      delayMicroseconds(10);
-      for (uint8_t col = 0; col < _Props::matrix_columns; col++) {
-        bool current_state = !digitalRead(_Props::matrix_col_pins[col]);
-
-        if (current_state != getMatrixState(row, col)) {
-          if (++debounce_counters_[row][col] >= DEBOUNCE_THRESHOLD) {
-            if (!queueKeyEvent(row, col, current_state)) {
-              // Queue is full, we'll try again next scan
-              continue;
-            }
-            debounce_counters_[row][col] = 0;
-          }
+      typename _Props::RowState hot_pins = readRow(row);
+      // Changes that are already waiting to be queued were counted as
+      // overflows when they first didn't fit.
+      typename _Props::RowState new_changes = debouncers_[row].debounce(hot_pins) & ~unqueued_changes_[row];
+      unqueued_changes_[row] |= new_changes;
+      any_hot_pins |= hot_pins;
+      any_pressed |= debouncers_[row].state() | unqueued_changes_[row];
+      // Keys still being debounced count as changing, too.
+      any_changing |= unqueued_changes_[row] | (hot_pins ^ debouncers_[row].state());
+
+      typename _Props::RowState state   = debouncers_[row].state();
+      typename _Props::RowState changes = unqueued_changes_[row];
+      for (uint8_t col = 0; changes != 0; col++, changes >>= 1) {
+        if (!(changes & 1))
+          continue;
+        if (!sendToEventQueue(row, col, bitRead(state, col))) {
+          // Queue is full, we'll try again next scan
+          if (bitRead(new_changes, col))
+            countQueueOverflow();
+          continue;
         }
+        unqueued_changes_[row] &= ~(typename _Props::RowState(1) << col);
       }
-      digitalWrite(_Props::matrix_row_pins[row], HIGH);
     }
+
+    uint32_t now = millis();
+    if (scan_rate_.update(any_changing != 0, now)) {
+      // The timer was cleared by the compare match that got us here, but
+      // clear it again, so that a shorter interval can't be overshot.
+      NRF_TIMER1->CC[0]       = scan_rate_.interval();
+      NRF_TIMER1->TASKS_CLEAR = 1;
+    }
+
+    if (idle_tracker_.update(!any_hot_pins && !any_pressed, now))
+      idleMatrix();
   }
 
  private:
-  static constexpr uint8_t DEBOUNCE_THRESHOLD = 3;
-  static uint8_t debounce_counters_[_Props::matrix_rows][_Props::matrix_columns];
+  static typename _Props::Debouncer debouncers_[_Props::matrix_rows];
+  static IdleTracker idle_tracker_;
+  static ScanRate scan_rate_;
+  // Debounced changes that didn't fit in the event queue yet
+  static typename _Props::RowState unqueued_changes_[_Props::matrix_rows];
+
+  // GPIO port registers and pin masks for the rows and columns, so the timer
+  // handler doesn't need to go through the Arduino pin mapping on each scan.
+  static NRF_GPIO_Type *row_ports_[_Props::matrix_rows];
+  static uint32_t row_masks_[_Props::matrix_rows];
+  static uint8_t col_ports_[_Props::matrix_columns];
+  static uint32_t col_masks_[_Props::matrix_columns];
+
+  static NRF_GPIO_Type *gpioPort(uint8_t arduino_pin) {
+#ifdef NRF_P1
+    if (g_ADigitalPinMap[arduino_pin] >= 32)
+      return NRF_P1;
+#endif
+    return NRF_P0;
+  }
+  static uint32_t gpioMask(uint8_t arduino_pin) {
+    return 1UL << (g_ADigitalPinMap[arduino_pin] & 31);
+  }
+
+  // Bits of the `idle_sense_pins` that were sensed when the scanner went idle
+  static uint32_t idle_sensed_pins_;
+
+  static volatile uint32_t &pinConfig(uint8_t arduino_pin) {
+    return gpioPort(arduino_pin)->PIN_CNF[g_ADigitalPinMap[arduino_pin] & 31];
+  }
+  static void setPinSense(uint8_t arduino_pin, uint32_t sense) {
+    volatile uint32_t &cnf = pinConfig(arduino_pin);
+    cnf                    = (cnf & ~GPIO_PIN_CNF_SENSE_Msk) | (sense << GPIO_PIN_CNF_SENSE_Pos);
+  }
+  static void setColumnSense(uint8_t col, uint32_t sense) {
+    setPinSense(_Props::matrix_col_pins[col], sense);
+  }
+
+  /// @brief Stop scanning until a key is pressed
+  /// With all rows driven low, a keypress pulls its column low, which raises
+  /// the GPIO PORT event, and the PPI channel routes that to the timer's start
+  /// task, so the next scan happens without any interrupt handler of our own.
+  static void idleMatrix() {
+    NRF_TIMER1->TASKS_STOP  = 1;
+    NRF_TIMER1->TASKS_CLEAR = 1;
+
+    for (uint8_t i = 0; i < _Props::matrix_rows; i++) {
+      row_ports_[i]->OUTCLR = row_masks_[i];
+    }
+
+    // Other sensed pins mustn't hold DETECT high, so they sense the level
+    // they aren't at until the scanner wakes.
+    idle_sensed_pins_ = 0;
+    for (uint8_t i = 0; i < sizeof(_Props::idle_sense_pins); i++) {
+      uint8_t arduino_pin = _Props::idle_sense_pins[i];
+      if ((pinConfig(arduino_pin) & GPIO_PIN_CNF_SENSE_Msk) == 0)
+        continue;
+      idle_sensed_pins_ |= 1UL << i;
+      bool high = gpioPort(arduino_pin)->IN & gpioMask(arduino_pin);
+      setPinSense(arduino_pin, high ? GPIO_PIN_CNF_SENSE_Low : GPIO_PIN_CNF_SENSE_High);
+    }
+
+    NRF_GPIOTE->EVENTS_PORT                        = 0;
+    NRF_PPI->CH[_Props::idle_wake_ppi_channel].EEP = (uint32_t)&NRF_GPIOTE->EVENTS_PORT;
+    NRF_PPI->CH[_Props::idle_wake_ppi_channel].TEP = (uint32_t)&NRF_TIMER1->TASKS_START;
+    NRF_PPI->CHENSET                               = 1UL << _Props::idle_wake_ppi_channel;
+
+    // A key that is already down raises the event as soon as its column is
+    // sensed, so enabling sensing last doesn't lose it.
+    for (uint8_t i = 0; i < _Props::matrix_columns; i++) {
+      setColumnSense(i, GPIO_PIN_CNF_SENSE_Low);
+    }
+  }
+
+  static void wakeMatrix() {
+    NRF_PPI->CHENCLR = 1UL << _Props::idle_wake_ppi_channel;
+    for (uint8_t i = 0; i < _Props::matrix_columns; i++) {
+      setColumnSense(i, GPIO_PIN_CNF_SENSE_Disabled);
+    }
+    for (uint8_t i = 0; i < sizeof(_Props::idle_sense_pins); i++) {
+      if (bitRead(idle_sensed_pins_, i))
+        setPinSense(_Props::idle_sense_pins[i], GPIO_PIN_CNF_SENSE_Low);
+    }
+    NRF_GPIOTE->EVENTS_PORT = 0;
+
+    for (uint8_t i = 0; i < _Props::matrix_rows; i++) {
+      row_ports_[i]->OUTSET = row_masks_[i];
+    }
+    idle_tracker_.wake(millis());
+  }
 
   static void gpio_handler(uint32_t pin) {
     // Wake-on-key handler
@@ -311,7 +585,31 @@ class NRF52KeyScanner : public Base<_Props>, public TimerHandlerInterface {
 
 // Static member initialization
 template<typename _Props>
-uint8_t NRF52KeyScanner<_Props>::debounce_counters_[_Props::matrix_rows][_Props::matrix_columns] = {0};
+typename _Props::Debouncer NRF52KeyScanner<_Props>::debouncers_[_Props::matrix_rows];
+
+template<typename _Props>
+typename _Props::RowState NRF52KeyScanner<_Props>::unqueued_changes_[_Props::matrix_rows];
+
+template<typename _Props>
+IdleTracker NRF52KeyScanner<_Props>::idle_tracker_;
+
+template<typename _Props>
+uint32_t NRF52KeyScanner<_Props>::idle_sensed_pins_;
+
+template<typename _Props>
+ScanRate NRF52KeyScanner<_Props>::scan_rate_;
+
+template<typename _Props>
+NRF_GPIO_Type *NRF52KeyScanner<_Props>::row_ports_[_Props::matrix_rows];
+
+template<typename _Props>
+uint32_t NRF52KeyScanner<_Props>::row_masks_[_Props::matrix_rows];
+
+template<typename _Props>
+uint8_t NRF52KeyScanner<_Props>::col_ports_[_Props::matrix_columns];
+
+template<typename _Props>
+uint32_t NRF52KeyScanner<_Props>::col_masks_[_Props::matrix_columns];
 
 template<typename _Props>
 StaticQueue_t NRF52KeyScanner<_Props>::event_queue_buffer_;
@@ -328,6 +626,12 @@ typename NRF52KeyScanner<_Props>::row_state_t NRF52KeyScanner<_Props>::matrix_st
 template<typename _Props>
 uint32_t NRF52KeyScanner<_Props>::next_scan_at_ = 0;
 
+template<typename _Props>
+EventBatch<typename NRF52KeyScanner<_Props>::Event, NRF52KeyScanner<_Props>::EVENT_QUEUE_SIZE> NRF52KeyScanner<_Props>::event_batch_;
+
+template<typename _Props>
+uint16_t NRF52KeyScanner<_Props>::queue_overflows_ = 0;
+
 }  // namespace keyscanner
 }  // namespace driver
 }  // namespace kaleidoscope
@@ -0,0 +1,127 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint16_t, uint32_t, UINT16_MAX
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/* Adapts the interval between matrix scans to the activity on the matrix
+ *
+ * While keys are changing, the scanner scans every `fast` microseconds. Once
+ * the matrix has been quiet (keys may be held, but none is changing, or being
+ * debounced) for `decay` milliseconds, the interval doubles, and keeps
+ * doubling every `decay` milliseconds until it reaches `slow`. The first scan
+ * that sees a key change goes straight back to the fast interval.
+ *
+ * A change is thus seen at most one slow interval late, and debounced at the
+ * fast rate from then on. Only a change that is undone again within a single
+ * slow interval can be missed, so `slow` should stay well below the time a key
+ * is held in a quick tap.
+ *
+ * If `slow` is not longer than `fast` (by default, it's zero), the interval is
+ * fixed.
+ *
+ * A scanner whose timer can't count up to every `uint16_t` interval sets its
+ * longest one with `setMaxInterval()`, before setting the intervals: longer
+ * fast and slow intervals are clamped to it.
+ */
+class ScanRate {
+ public:
+  void setMaxInterval(uint16_t interval) {
+    max_ = interval;
+  }
+  uint16_t maxInterval() const {
+    return max_;
+  }
+  void setFastInterval(uint16_t interval) {
+    fast_ = clamp(interval);
+  }
+  uint16_t fastInterval() const {
+    return fast_;
+  }
+  void setSlowInterval(uint16_t interval) {
+    slow_ = clamp(interval);
+  }
+  uint16_t slowInterval() const {
+    return slow_;
+  }
+  void setDecay(uint16_t decay) {
+    decay_ = decay;
+  }
+  uint16_t decay() const {
+    return decay_;
+  }
+
+  bool isAdaptive() const {
+    return fast_ != 0 && slow_ > fast_;
+  }
+
+  /// The interval until the next scan, in microseconds.
+  uint16_t interval() const {
+    return interval_;
+  }
+
+  /// Record the result of a full matrix scan, made at time `now` (in
+  /// milliseconds). Returns `true` if the interval changed, and the scanner
+  /// needs to reprogram its timer.
+  bool update(bool active, uint32_t now) {
+    uint32_t interval = fast_;
+    if (active) {
+      last_activity_ = now;
+    } else if (isAdaptive()) {
+      uint32_t quiet = now - last_activity_;
+      if (decay_ == 0) {
+        interval = slow_;
+      } else {
+        for (uint32_t t = decay_; t <= quiet && interval < slow_; t += decay_)
+          interval <<= 1;
+      }
+      if (interval > slow_)
+        interval = slow_;
+    }
+
+    if (interval == interval_)
+      return false;
+    interval_ = interval;
+    return true;
+  }
+
+ private:
+  uint16_t clamp(uint16_t interval) const {
+    return interval > max_ ? max_ : interval;
+  }
+
+  uint32_t last_activity_ = 0;
+  uint16_t fast_          = 0;
+  uint16_t slow_          = 0;
+  uint16_t decay_         = 0;
+  uint16_t interval_      = 0;
+  uint16_t max_           = UINT16_MAX;
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -23,9 +23,11 @@
 
 #pragma once
 
-#include <stdint.h>                               // for uint16_t, uint8_t, uint32_t
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for BaseProps
-#include "kaleidoscope/driver/keyscanner/None.h"  // for None
+#include <stdint.h>                                      // for uint16_t, uint8_t, uint32_t
+#include "kaleidoscope/driver/keyscanner/Base.h"         // for BaseProps
+#include "kaleidoscope/driver/keyscanner/Debounce.h"     // for Symmetric
+#include "kaleidoscope/driver/keyscanner/GhostFilter.h"  // for GhostFilter
+#include "kaleidoscope/driver/keyscanner/None.h"         // for None
 
 
 namespace kaleidoscope {
@@ -36,6 +38,11 @@ namespace keyscanner {
 struct SimpleProps : kaleidoscope::driver::keyscanner::BaseProps {
   static const uint32_t keyscan_interval_micros = 1500;
   typedef uint16_t RowState;
+  // Boards that change `RowState` need to change this to match.
+  typedef debounce::Symmetric<RowState> Debouncer;
+  // Boards without a diode on every key can turn this on to hold back keys
+  // that might be ghosts (see `GhostFilter`).
+  static constexpr bool ghost_detection = false;
 
   /*
    * The following two lines declare an empty array. Both of these must be
@@ -50,22 +57,10 @@ struct SimpleProps : kaleidoscope::driver::keyscanner::BaseProps {
 template<typename _KeyScannerProps>
 class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
  protected:
-  /*
-    each of these variables are storing the state for a row of keys
-
-    so for key 0, the counter is represented by db0[0] and db1[0]
-    and the state in debounced_state[0].
-  */
-  struct debounce_t {
-    typename _KeyScannerProps::RowState db0;              // counter bit 0
-    typename _KeyScannerProps::RowState db1;              // counter bit 1
-    typename _KeyScannerProps::RowState debounced_state;  // debounced state
-  };
-
   struct row_state_t {
     typename _KeyScannerProps::RowState previous;
     typename _KeyScannerProps::RowState current;
-    debounce_t debouncer;
+    typename _KeyScannerProps::Debouncer debouncer;
   };
 
  private:
@@ -118,14 +113,11 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
       digitalWrite(_KeyScannerProps::matrix_row_pins[current_row], HIGH);
 
 
-      any_debounced_changes |= debounce(hot_pins, &matrix_state_[current_row].debouncer);
-
-      if (any_debounced_changes) {
-        for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
-          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.debounced_state;
-        }
-      }
+      any_debounced_changes |= matrix_state_[current_row].debouncer.debounce(hot_pins);
     }
+
+    if (any_debounced_changes)
+      acceptDebouncedState();
     postReadMatrix();
   }
 
@@ -183,8 +175,31 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
                     key_addr.col()) != 0);
   }
 
+  void raiseDebounce(typename _KeyScannerProps::KeyAddr key_addr) {
+    matrix_state_[key_addr.row()].debouncer.penalize(key_addr.col());
+  }
+
 
  private:
+  void acceptDebouncedState() {
+    if (_KeyScannerProps::ghost_detection) {
+      GhostFilter<typename _KeyScannerProps::RowState, _KeyScannerProps::matrix_rows> ghosts;
+      ghosts.detect([](uint8_t row) {
+        return matrix_state_[row].debouncer.state();
+      });
+      for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
+        matrix_state_[row].current = ghosts.filter(row,
+                                                   matrix_state_[row].debouncer.state(),
+                                                   matrix_state_[row].current);
+      }
+      return;
+    }
+
+    for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
+      matrix_state_[row].current = matrix_state_[row].debouncer.state();
+    }
+  }
+
   /*
    * This function has loop unrolling disabled on purpose: we want to give the
    * hardware enough time to produce stable PIN reads for us. If we unroll the
@@ -210,30 +225,6 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
 
     return hot_pins;
   }
-
-  static inline typename _KeyScannerProps::RowState debounce(
-    typename _KeyScannerProps::RowState sample, debounce_t *debouncer) {
-    typename _KeyScannerProps::RowState delta, changes;
-
-    // Use xor to detect changes from last stable state:
-    // if a key has changed, it's bit will be 1, otherwise 0
-    delta = sample ^ debouncer->debounced_state;
-
-    // Increment counters and reset any unchanged bits:
-    // increment bit 1 for all changed keys
-    debouncer->db1 = ((debouncer->db1) ^ (debouncer->db0)) & delta;
-    // increment bit 0 for all changed keys
-    debouncer->db0 = ~(debouncer->db0) & delta;
-
-    // Calculate returned change set: if delta is still true
-    // and the counter has wrapped back to 0, the key is changed.
-
-    changes = ~(~delta | (debouncer->db0) | (debouncer->db1));
-    // Update state: in this case use xor to flip any bit that is true in changes.
-    debouncer->debounced_state ^= changes;
-
-    return changes;
-  }
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 template<typename _KeyScannerProps>
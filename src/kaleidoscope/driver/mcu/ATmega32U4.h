@@ -25,6 +25,10 @@
 
 #include "kaleidoscope/driver/mcu/Base.h"  // for Base, BaseProps
 
+#ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+#include <avr/sleep.h>
+#endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+
 namespace kaleidoscope {
 namespace driver {
 namespace mcu {
@@ -83,6 +87,16 @@ class ATmega32U4 : public kaleidoscope::driver::mcu::Base<_Props> {
   bool USBConfigured() {
     return USBDevice.configured();
   }
+
+  /* Idle sleep mode keeps the timers and the USB controller running, so any of
+   * their interrupts wake us up again. If the interrupt we're waiting for fires
+   * right before we go to sleep, the next tick of the millis() timer will
+   * still wake us, a millisecond later at most.
+   */
+  void waitForInterrupt() {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+  }
 };
 #else
 template<typename _Props>
@@ -76,6 +76,14 @@ class Base {
   }
 
   void setUSBResetHook(void (*hook)()) {}
+
+  /**
+   * Wait for the next interrupt, in a low power state if the MCU has one.
+   *
+   * This must return on any interrupt, including the ones that advance
+   * `millis()`. The default implementation returns immediately.
+   */
+  void waitForInterrupt() {}
 };
 
 }  // namespace mcu
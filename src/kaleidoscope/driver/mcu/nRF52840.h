@@ -59,6 +59,15 @@ class nRF52840 : public kaleidoscope::driver::mcu::Base<_Props> {
     (void)hook;
   }
 
+  /**
+   * @brief Sleep until the next event or interrupt
+   * Uses WFE, or the SoftDevice's equivalent when it is enabled. The key
+   * scanner's timer interrupt and the RTOS tick both wake us up.
+   */
+  void waitForInterrupt() {
+    waitForEvent();
+  }
+
   /**
    * @brief Check if USB data connection is active
    * @return true if USB is configured and ready for data transfer
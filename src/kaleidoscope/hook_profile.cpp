@@ -0,0 +1,84 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/hook_profile.h"
+
+#include <Arduino.h>  // for pgm_read_byte, PROGMEM
+#include <stdint.h>   // for uint8_t, uint32_t
+
+#include "kaleidoscope/event_handlers.h"  // for _FOR_EACH_EVENT_HANDLER
+
+namespace kaleidoscope {
+namespace hook_profile {
+
+#define _HOOK_PROFILE_NAME(HOOK_NAME, ...) #HOOK_NAME ","
+
+static const char hook_names_[] PROGMEM = _FOR_EACH_EVENT_HANDLER(_HOOK_PROFILE_NAME);
+
+// The following weak symbols are overridden by KALEIDOSCOPE_INIT_PLUGINS(...)
+// when the sketch is built with KALEIDOSCOPE_HOOK_PROFILING enabled. Without
+// it, there are no plugins being profiled, and nothing is recorded.
+
+__attribute__((weak)) uint8_t pluginCount() {
+  return 0;
+}
+__attribute__((weak)) const char *pluginNameList() {
+  return nullptr;
+}
+__attribute__((weak)) HookStats stats(uint8_t plugin, Hook hook) {
+  return HookStats{};
+}
+__attribute__((weak)) void reset() {}
+__attribute__((weak)) void record(uint8_t plugin, Hook hook, uint32_t elapsed_us) {}
+
+// Both name lists are stored in PROGMEM as a single string, with the names
+// separated by commas (and, for the plugins, spaces).
+static void copyListEntry(const char *list, uint8_t index, char *buffer, uint8_t size) {
+  uint8_t length = 0;
+  if (list != nullptr) {
+    char c;
+    while (index > 0 && (c = pgm_read_byte(list)) != '\0') {
+      if (c == ',')
+        --index;
+      ++list;
+    }
+    while ((c = pgm_read_byte(list)) == ' ')
+      ++list;
+    while ((c = pgm_read_byte(list)) != '\0' && c != ',' && length + 1 < size) {
+      buffer[length++] = c;
+      ++list;
+    }
+  }
+  if (size > 0)
+    buffer[length] = '\0';
+}
+
+void pluginName(uint8_t plugin, char *buffer, uint8_t size) {
+  copyListEntry(pluginNameList(), plugin, buffer, size);
+}
+
+void hookName(Hook hook, char *buffer, uint8_t size) {
+  copyListEntry(hook_names_, hook, buffer, size);
+}
+
+}  // namespace hook_profile
+}  // namespace kaleidoscope
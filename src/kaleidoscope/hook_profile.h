@@ -0,0 +1,143 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for micros, PROGMEM
+#include <stdint.h>   // for uint8_t, uint32_t
+#include <string.h>   // for memset
+
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/event_handlers.h"        // for _FOR_EACH_EVENT_HANDLER
+#include "kaleidoscope/macro_helpers.h"         // for __NL__
+#include "kaleidoscope/macro_map.h"             // for MAP
+
+// Hook profiling is opt-in. To use it, define `KALEIDOSCOPE_HOOK_PROFILING` to
+// `1` before including `Kaleidoscope.h` in the sketch (or in the build flags).
+// Every call that `Hooks` dispatches to a plugin is then timed, and the number
+// of calls, the total time, and the longest call are recorded for each plugin
+// and each hook. This costs twelve bytes of RAM per plugin per hook, and two
+// calls to `micros()` per plugin call.
+#ifndef KALEIDOSCOPE_HOOK_PROFILING
+#define KALEIDOSCOPE_HOOK_PROFILING 0
+#endif
+
+namespace kaleidoscope {
+namespace hook_profile {
+
+#define _HOOK_PROFILE_ID(HOOK_NAME, ...) HOOK_NAME,
+
+// One id for each hook, in the order they are declared in `event_handlers.h`.
+enum Hook : uint8_t {
+  _FOR_EACH_EVENT_HANDLER(_HOOK_PROFILE_ID)
+    hook_count,
+};
+
+struct HookStats {
+  uint32_t calls;
+  uint32_t total_us;
+  uint32_t max_us;
+};
+
+// The number of plugins being profiled. This is zero if the sketch was not
+// built with `KALEIDOSCOPE_HOOK_PROFILING` enabled.
+uint8_t pluginCount();
+
+// The statistics recorded for one plugin (by its position in the
+// `KALEIDOSCOPE_INIT_PLUGINS()` list) and one hook since the last `reset()`.
+HookStats stats(uint8_t plugin, Hook hook);
+
+// Clears all statistics.
+void reset();
+
+// Copy the name of a plugin (as written in `KALEIDOSCOPE_INIT_PLUGINS()`) or a
+// hook into `buffer`, truncating it if necessary.
+void pluginName(uint8_t plugin, char *buffer, uint8_t size);
+void hookName(Hook hook, char *buffer, uint8_t size);
+
+// Internal, used by the code generated by `KALEIDOSCOPE_INIT_PLUGINS()`.
+const char *pluginNameList();
+void record(uint8_t plugin, Hook hook, uint32_t elapsed_us);
+
+template<typename EventHandler__, typename Plugin__, typename... Args__>
+inline EventHandlerResult profiledCall(uint8_t plugin_index,
+                                       Plugin__ &plugin,
+                                       Args__ &&...hook_args) {
+  // Plugins that don't implement the hook are left out of the statistics.
+  if (!EventHandler__::template isImplementedBy<Plugin__>())
+    return EventHandler__::call(plugin, hook_args...);
+
+  uint32_t start_us         = micros();
+  EventHandlerResult result = EventHandler__::call(plugin, hook_args...);
+  record(plugin_index, EventHandler__::hook(), micros() - start_us);
+  return result;
+}
+
+}  // namespace hook_profile
+}  // namespace kaleidoscope
+
+#if KALEIDOSCOPE_HOOK_PROFILING
+
+#define _HOOK_PROFILE_COUNT_PLUGIN(PLUGIN) +1
+
+// This defines the statistics table, sized for the plugins given to
+// KALEIDOSCOPE_INIT_PLUGINS(), and the functions that give access to it. They
+// override the weak definitions in hook_profile.cpp.
+#define _INIT_HOOK_PROFILE(...)                                             __NL__ \
+  namespace kaleidoscope {                                                  __NL__ \
+  namespace hook_profile {                                                  __NL__ \
+                                                                            __NL__ \
+  static constexpr uint8_t plugin_count                                     __NL__ \
+    = 0 MAP(_HOOK_PROFILE_COUNT_PLUGIN, __VA_ARGS__);                       __NL__ \
+                                                                            __NL__ \
+  static HookStats stats_[plugin_count][hook_count];                        __NL__ \
+                                                                            __NL__ \
+  static const char plugin_names_[] PROGMEM = #__VA_ARGS__;                 __NL__ \
+                                                                            __NL__ \
+  uint8_t pluginCount() {                                                   __NL__ \
+    return plugin_count;                                                    __NL__ \
+  }                                                                         __NL__ \
+  const char *pluginNameList() {                                            __NL__ \
+    return plugin_names_;                                                   __NL__ \
+  }                                                                         __NL__ \
+  HookStats stats(uint8_t plugin, Hook hook) {                              __NL__ \
+    return stats_[plugin][hook];                                            __NL__ \
+  }                                                                         __NL__ \
+  void reset() {                                                            __NL__ \
+    memset(stats_, 0, sizeof(stats_));                                      __NL__ \
+  }                                                                         __NL__ \
+  void record(uint8_t plugin, Hook hook, uint32_t elapsed_us) {             __NL__ \
+    HookStats &entry = stats_[plugin][hook];                                __NL__ \
+    ++entry.calls;                                                          __NL__ \
+    entry.total_us += elapsed_us;                                           __NL__ \
+    if (elapsed_us > entry.max_us)                                          __NL__ \
+      entry.max_us = elapsed_us;                                            __NL__ \
+  }                                                                         __NL__ \
+                                                                            __NL__ \
+  } /* namespace hook_profile */                                            __NL__ \
+  } /* namespace kaleidoscope */
+
+#else
+
+#define _INIT_HOOK_PROFILE(...)
+
+#endif
@@ -0,0 +1,80 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/latency_histogram.h"
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/KeyEvent.h"  // for KeyEvent
+
+namespace kaleidoscope {
+namespace latency_histogram {
+
+// The following weak symbols are overridden by KALEIDOSCOPE_INIT_PLUGINS(...)
+// when the sketch is built with KALEIDOSCOPE_LATENCY_HISTOGRAM enabled.
+// Without it, there is no histogram, and nothing is recorded.
+
+__attribute__((weak)) uint8_t bucketCount() {
+  return 0;
+}
+__attribute__((weak)) uint16_t bucketMicros() {
+  return 0;
+}
+__attribute__((weak)) uint16_t bucket(uint8_t index) {
+  return 0;
+}
+__attribute__((weak)) uint32_t count() {
+  return 0;
+}
+__attribute__((weak)) uint32_t maxMicros() {
+  return 0;
+}
+__attribute__((weak)) void reset() {}
+__attribute__((weak)) void record(uint32_t elapsed_us) {}
+__attribute__((weak)) void recordEvent(const KeyEvent &event) {}
+
+uint32_t percentile(uint8_t percent) {
+  // Bucket counts saturate, so the total is taken from the buckets themselves
+  // rather than from `count()`, to keep the two consistent.
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < bucketCount(); i++)
+    total += bucket(i);
+  if (total == 0)
+    return 0;
+
+  // The rank of the sample we're looking for, rounded up, and at least one.
+  uint32_t rank = (total * percent + 99) / 100;
+  if (rank == 0)
+    rank = 1;
+
+  uint32_t seen = 0;
+  uint8_t last  = bucketCount() - 1;
+  for (uint8_t i = 0; i < last; i++) {
+    seen += bucket(i);
+    if (seen >= rank)
+      return uint32_t(i + 1) * bucketMicros();
+  }
+  return maxMicros();
+}
+
+}  // namespace latency_histogram
+}  // namespace kaleidoscope
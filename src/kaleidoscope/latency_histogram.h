@@ -0,0 +1,157 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * Additional Permissions:
+ * As an additional permission under Section 7 of the GNU General Public
+ * License Version 3, you may link this software against a Vendor-provided
+ * Hardware Specific Software Module under the terms of the MCU Vendor
+ * Firmware Library Additional Permission Version 1.0.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for micros
+#include <stdint.h>   // for uint8_t, uint16_t, uint32_t, UINT16_MAX
+#include <string.h>   // for memset
+
+#include "kaleidoscope/KeyEvent.h"         // for KeyEvent
+#include "kaleidoscope/keyswitch_state.h"  // for keyIsInjected, keyToggledOff, keyToggledOn
+#include "kaleidoscope/macro_helpers.h"    // for __NL__
+
+// The input latency histogram is opt-in. To use it, define
+// `KALEIDOSCOPE_LATENCY_HISTOGRAM` to `1` before including `Kaleidoscope.h` in
+// the sketch (or in the build flags). For every keyswitch event that results
+// in a keyboard report, the time from the key scanner detecting the event (or,
+// if the scanner doesn't say, from the start of the cycle in which it was
+// scanned) until the report has been handed to the HID driver is then added to
+// a histogram of `KALEIDOSCOPE_LATENCY_BUCKETS` buckets, each
+// `KALEIDOSCOPE_LATENCY_BUCKET_MICROS` wide. The last bucket also collects
+// everything longer than that. This costs two bytes of RAM per bucket, and a
+// call to `micros()` per report.
+#ifndef KALEIDOSCOPE_LATENCY_HISTOGRAM
+#define KALEIDOSCOPE_LATENCY_HISTOGRAM 0
+#endif
+
+#ifndef KALEIDOSCOPE_LATENCY_BUCKETS
+#define KALEIDOSCOPE_LATENCY_BUCKETS 32
+#endif
+
+#ifndef KALEIDOSCOPE_LATENCY_BUCKET_MICROS
+#define KALEIDOSCOPE_LATENCY_BUCKET_MICROS 500
+#endif
+
+namespace kaleidoscope {
+namespace latency_histogram {
+
+// The number of buckets, and the width of each of them in microseconds. The
+// bucket count is zero if the sketch was not built with
+// `KALEIDOSCOPE_LATENCY_HISTOGRAM` enabled.
+uint8_t bucketCount();
+uint16_t bucketMicros();
+
+// The number of samples in a bucket since the last `reset()`. Bucket counts
+// stop at 65535.
+uint16_t bucket(uint8_t index);
+
+// The total number of samples, and the longest latency seen, since the last
+// `reset()`.
+uint32_t count();
+uint32_t maxMicros();
+
+// Clears the histogram.
+void reset();
+
+// An upper bound on the given percentile of the recorded latencies, in
+// microseconds: the upper edge of the bucket it falls into, or the longest
+// latency if that's in the last bucket. Returns zero if nothing was recorded.
+uint32_t percentile(uint8_t percent);
+
+// Add a latency to the histogram. This is what `Runtime` uses, and tests can
+// use it to add samples of their own.
+void record(uint32_t elapsed_us);
+
+// Internal, called by `Runtime` once the report for `event` has been sent.
+void recordEvent(const KeyEvent &event);
+
+// Events that come from the key scanner, and toggle a key on or off, are the
+// ones whose latency is recorded.
+inline bool isMeasured(const KeyEvent &event) {
+  return event.addr.isValid() &&
+         !keyIsInjected(event.state) &&
+         (keyToggledOn(event.state) || keyToggledOff(event.state));
+}
+
+}  // namespace latency_histogram
+}  // namespace kaleidoscope
+
+#if KALEIDOSCOPE_LATENCY_HISTOGRAM
+
+// This defines the histogram, and the functions that give access to it. They
+// override the weak definitions in latency_histogram.cpp.
+#define _INIT_LATENCY_HISTOGRAM()                                           __NL__ \
+  namespace kaleidoscope {                                                  __NL__ \
+  namespace latency_histogram {                                             __NL__ \
+                                                                            __NL__ \
+  static uint16_t buckets_[KALEIDOSCOPE_LATENCY_BUCKETS];                   __NL__ \
+  static uint32_t count_;                                                   __NL__ \
+  static uint32_t max_us_;                                                  __NL__ \
+                                                                            __NL__ \
+  uint8_t bucketCount() {                                                   __NL__ \
+    return KALEIDOSCOPE_LATENCY_BUCKETS;                                    __NL__ \
+  }                                                                         __NL__ \
+  uint16_t bucketMicros() {                                                 __NL__ \
+    return KALEIDOSCOPE_LATENCY_BUCKET_MICROS;                              __NL__ \
+  }                                                                         __NL__ \
+  uint16_t bucket(uint8_t index) {                                          __NL__ \
+    return buckets_[index];                                                 __NL__ \
+  }                                                                         __NL__ \
+  uint32_t count() {                                                        __NL__ \
+    return count_;                                                          __NL__ \
+  }                                                                         __NL__ \
+  uint32_t maxMicros() {                                                    __NL__ \
+    return max_us_;                                                         __NL__ \
+  }                                                                         __NL__ \
+  void reset() {                                                            __NL__ \
+    memset(buckets_, 0, sizeof(buckets_));                                  __NL__ \
+    count_  = 0;                                                            __NL__ \
+    max_us_ = 0;                                                            __NL__ \
+  }                                                                         __NL__ \
+  void record(uint32_t elapsed_us) {                                        __NL__ \
+    uint32_t index = elapsed_us / KALEIDOSCOPE_LATENCY_BUCKET_MICROS;       __NL__ \
+    if (index >= KALEIDOSCOPE_LATENCY_BUCKETS)                              __NL__ \
+      index = KALEIDOSCOPE_LATENCY_BUCKETS - 1;                             __NL__ \
+    if (buckets_[index] != UINT16_MAX)                                      __NL__ \
+      ++buckets_[index];                                                    __NL__ \
+    ++count_;                                                               __NL__ \
+    if (elapsed_us > max_us_)                                               __NL__ \
+      max_us_ = elapsed_us;                                                 __NL__ \
+  }                                                                         __NL__ \
+  void recordEvent(const KeyEvent &event) {                                 __NL__ \
+    if (!isMeasured(event))                                                 __NL__ \
+      return;                                                               __NL__ \
+    uint32_t detected_at = event.timestamp();                               __NL__ \
+    if (detected_at == 0)                                                   __NL__ \
+      detected_at = Runtime.microsAtCycleStart();                           __NL__ \
+    record(micros() - detected_at);                                         __NL__ \
+  }                                                                         __NL__ \
+                                                                            __NL__ \
+  } /* namespace latency_histogram */                                       __NL__ \
+  } /* namespace kaleidoscope */
+
+#else
+
+#define _INIT_LATENCY_HISTOGRAM()
+
+#endif
@@ -20,21 +20,24 @@
  * this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <stdint.h>  // for uint8_t, int8_t
-#include <string.h>  // for memmove, memset
-
-#include "kaleidoscope/KeyAddr.h"          // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
-#include "kaleidoscope/KeyEvent.h"         // for KeyEvent
-#include "kaleidoscope/KeyMap.h"           // for KeyMap
-#include "kaleidoscope/LiveKeys.h"         // for LiveKeys, live_keys
-#include "kaleidoscope/device/device.h"    // for Device
-#include "kaleidoscope/hooks.h"            // for Hooks
-#include "kaleidoscope/key_defs.h"         // for Key, LAYER_MOVE_OFFSET, LAYER_SHIFT_OFFSET
-#include "kaleidoscope/keymaps.h"          // for keyFromKeymap
-#include "kaleidoscope/keyswitch_state.h"  // for keyToggledOn
-#include "kaleidoscope/layers.h"           // for Layer_, Layer, Layer_::GetKeyFunction, Layer_:...
-#include "kaleidoscope_internal/device.h"  // for device
+#include <Arduino.h>  // for pgm_read_byte
+#include <stdint.h>   // for uint8_t, int8_t
+#include <string.h>   // for memmove, memset
+
+#include "kaleidoscope/KeyAddr.h"                                         // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"                                 // for KeyAddrBitfield
+#include "kaleidoscope/KeyAddrMap.h"                                      // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyEvent.h"                                        // for KeyEvent
+#include "kaleidoscope/KeyMap.h"                                          // for KeyMap
+#include "kaleidoscope/LiveKeys.h"                                        // for LiveKeys, live_keys
+#include "kaleidoscope/device/device.h"                                   // for Device
+#include "kaleidoscope/hooks.h"                                           // for Hooks
+#include "kaleidoscope/key_defs.h"                                        // for Key, LAYER_MOVE_OFFSET, LAYER_SHIFT_OFFSET
+#include "kaleidoscope/keymaps.h"                                         // for keyFromKeymap
+#include "kaleidoscope/keyswitch_state.h"                                 // for keyToggledOn
+#include "kaleidoscope/layers.h"                                          // for Layer_, Layer, Layer_::GetKeyFunction, Layer_:...
+#include "kaleidoscope_internal/device.h"                                 // for device
+#include "kaleidoscope_internal/sketch_exploration/keymap_exploration.h"  // for progmemLayerCoverage
 
 // The following definitions of layer_count and keymaps_linear
 // are used if the user does not define a keymap within the sketch
@@ -56,6 +59,10 @@ int8_t Layer_::active_layers_[MAX_ACTIVE_LAYERS];
 uint8_t Layer_::active_layer_keymap_[kaleidoscope_internal::device.numKeys()];
 Layer_::GetKeyFunction Layer_::getKey = &Layer_::getKeyFromPROGMEM;
 
+KeyAddrBitfield Layer_::layer_coverage_[MAX_LAYER_COVERAGE];
+Layer_::GetKeyFunction Layer_::coverage_get_key_ = nullptr;
+uint8_t Layer_::coverage_layer_count_            = 0;
+
 void Layer_::setup() {
   // Update the active layer cache (every entry will be `0` to start)
   Layer.updateActiveLayers();
@@ -103,7 +110,7 @@ void Layer_::handleLayerKeyEvent(const KeyEvent &event) {
         activate(target_layer_shifted);
         // We can't just change `event.key` here because `live_keys[]` has
         // already been updated by the time `handleLayerKeyEvent()` gets called.
-        live_keys[event.addr] = ShiftToLayer(target_layer);
+        live_keys.activate(event.addr, ShiftToLayer(target_layer));
       }
       break;
 
@@ -149,22 +156,17 @@ Key Layer_::getKeyFromPROGMEM(uint8_t layer, KeyAddr key_addr) {
 }
 
 void Layer_::updateActiveLayers(void) {
-  // First, set every entry in the active layer keymap to point to the default
-  // layer (layer 0).
-  memset(active_layer_keymap_, 0, kaleidoscope_internal::device.numKeys());
+  // If the keymap has been replaced since the layer coverage bitmaps were last
+  // built, rebuild them first. That will call this function again.
+  if (!layerCoverageIsCurrent()) {
+    updateLayerCoverage();
+    return;
+  }
 
   // For each key address, set its entry in the active layer keymap to the value
   // of the top active layer that has a non-transparent entry for that address.
   for (auto key_addr : KeyAddr::all()) {
-    for (uint8_t i = active_layer_count_; i > 0; --i) {
-      uint8_t layer = unshifted(active_layers_[i - 1]);
-
-      Key key = (*getKey)(layer, key_addr);
-      if (key != Key_Transparent) {
-        active_layer_keymap_[key_addr.toInt()] = layer;
-        break;
-      }
-    }
+    active_layer_keymap_[key_addr.toInt()] = topLayerFor(key_addr);
   }
   // Even if there are no active layers (a situation that should be prevented by
   // `deactivate()`), each key will be mapped from the base layer (layer
@@ -173,6 +175,97 @@ void Layer_::updateActiveLayers(void) {
   // has been deactivated.
 }
 
+void Layer_::updateLayerCoverage() {
+  coverage_get_key_     = getKey;
+  coverage_layer_count_ = layer_count;
+
+  for (uint8_t layer = 0; layer < MAX_LAYER_COVERAGE; ++layer) {
+    layer_coverage_[layer].clear();
+    if (layer >= layer_count)
+      continue;
+    // For the PROGMEM keymap, the bitmaps were already computed at compile
+    // time, so we only need to copy them.
+    const uint8_t *progmem_coverage = (getKey == getKeyFromPROGMEM)
+                                        ? sketch_exploration::progmemLayerCoverage(layer)
+                                        : nullptr;
+    if (progmem_coverage != nullptr) {
+      for (uint8_t i = 0; i < KeyAddrBitfield::total_blocks; ++i) {
+        layer_coverage_[layer].block(i) = pgm_read_byte(&progmem_coverage[i]);
+      }
+      continue;
+    }
+    for (auto key_addr : KeyAddr::all()) {
+      if ((*getKey)(layer, key_addr) != Key_Transparent)
+        layer_coverage_[layer].set(key_addr);
+    }
+  }
+
+  updateActiveLayers();
+}
+
+void Layer_::updateLayerCoverage(uint8_t layer, KeyAddr key_addr) {
+  if (!layerCoverageIsCurrent()) {
+    updateLayerCoverage();
+    return;
+  }
+
+  if (layer < MAX_LAYER_COVERAGE && layer < layer_count) {
+    layer_coverage_[layer].write(key_addr, (*getKey)(layer, key_addr) != Key_Transparent);
+  }
+  active_layer_keymap_[key_addr.toInt()] = topLayerFor(key_addr);
+}
+
+bool Layer_::layerCoverageIsCurrent() {
+  return (coverage_get_key_ == getKey && coverage_layer_count_ == layer_count);
+}
+
+bool Layer_::coversKey(uint8_t layer, KeyAddr key_addr) {
+  if (layer < MAX_LAYER_COVERAGE)
+    return layer_coverage_[layer].read(key_addr);
+  return (*getKey)(layer, key_addr) != Key_Transparent;
+}
+
+uint8_t Layer_::topLayerFor(KeyAddr key_addr) {
+  for (uint8_t i = active_layer_count_; i > 0; --i) {
+    uint8_t layer = unshifted(active_layers_[i - 1]);
+    if (coversKey(layer, key_addr))
+      return layer;
+  }
+  return 0;
+}
+
+// Update the active layer keymap after `layer` has been put on top of the
+// stack. Only the keys that it covers are affected.
+void Layer_::raiseLayer(uint8_t layer) {
+  if (layer < MAX_LAYER_COVERAGE) {
+    for (KeyAddr key_addr : layer_coverage_[layer]) {
+      active_layer_keymap_[key_addr.toInt()] = layer;
+    }
+    return;
+  }
+  for (auto key_addr : KeyAddr::all()) {
+    if ((*getKey)(layer, key_addr) != Key_Transparent)
+      active_layer_keymap_[key_addr.toInt()] = layer;
+  }
+}
+
+// Update the active layer keymap after `layer` has been removed from the
+// stack. Only the keys that were mapped from it need to be looked up again,
+// because no other layer can have been hidden by it.
+void Layer_::lowerLayer(uint8_t layer) {
+  if (layer < MAX_LAYER_COVERAGE) {
+    for (KeyAddr key_addr : layer_coverage_[layer]) {
+      if (active_layer_keymap_[key_addr.toInt()] == layer)
+        active_layer_keymap_[key_addr.toInt()] = topLayerFor(key_addr);
+    }
+    return;
+  }
+  for (auto key_addr : KeyAddr::all()) {
+    if (active_layer_keymap_[key_addr.toInt()] == layer)
+      active_layer_keymap_[key_addr.toInt()] = topLayerFor(key_addr);
+  }
+}
+
 void Layer_::move(uint8_t layer) {
   // We do pretty much what activate() does, except we do everything
   // unconditionally, to make sure all parts of the firmware are aware of the
@@ -204,16 +297,25 @@ void Layer_::activate(uint8_t layer) {
 
   // Guarantee that we don't overflow by removing layers from the bottom if
   // we're about to exceed the size of the active layers array.
+  bool dropped_layers = false;
   while (active_layer_count_ >= MAX_ACTIVE_LAYERS) {
     remove(0);
+    dropped_layers = true;
   }
 
   // Otherwise, push it onto the active layer stack
   active_layers_[active_layer_count_++] = layer;
 
   // Update the keymap cache (but not live_composite_keymap_; that gets
-  // updated separately, when keys toggle on or off. See layers.h)
-  updateActiveLayers();
+  // updated separately, when keys toggle on or off. See layers.h). Moving a
+  // layer to the top of the stack only changes the keys that it covers, so
+  // unless layers were dropped from the bottom, we don't need to look at the
+  // rest.
+  if (dropped_layers || !layerCoverageIsCurrent()) {
+    updateActiveLayers();
+  } else {
+    raiseLayer(layer_unshifted);
+  }
 
   kaleidoscope::Hooks::onLayerChange();
 }
@@ -243,7 +345,11 @@ void Layer_::deactivate(uint8_t layer) {
   remove(current_pos);
 
   // Update the keymap cache.
-  updateActiveLayers();
+  if (layerCoverageIsCurrent()) {
+    lowerLayer(unshifted(layer));
+  } else {
+    updateActiveLayers();
+  }
 
   kaleidoscope::Hooks::onLayerChange();
 }
@@ -26,6 +26,7 @@
 #include <stdint.h>   // for uint8_t, int8_t
 
 #include "kaleidoscope/KeyAddr.h"                                         // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"                                 // for KeyAddrBitfield
 #include "kaleidoscope/KeyEvent.h"                                        // for KeyEvent
 #include "kaleidoscope/device/device.h"                                   // for Device
 #include "kaleidoscope/key_defs.h"                                        // for Key
@@ -52,6 +53,18 @@
 #define MAX_ACTIVE_LAYERS 16
 #endif
 
+// The number of layers for which a bitmap of non-transparent keys is kept in
+// RAM. These bitmaps let layer changes skip the keymap lookups for every key
+// that a layer doesn't cover. Layers above this limit still work, but changing
+// them falls back to looking up each of their keys.
+#ifndef MAX_LAYER_COVERAGE
+#ifdef __AVR__
+#define MAX_LAYER_COVERAGE 8
+#else
+#define MAX_LAYER_COVERAGE 32
+#endif
+#endif
+
 #define START_KEYMAPS                                                   __NL__ \
    constexpr Key keymaps_linear[][kaleidoscope_internal::device.matrix_rows * kaleidoscope_internal::device.matrix_columns] PROGMEM = {
 
@@ -137,6 +150,14 @@ class Layer_ {
 
   static void updateActiveLayers(void);
 
+  // Each layer (up to `MAX_LAYER_COVERAGE`) has a bitmap of the keys that are
+  // not transparent on it, which is used to work out which keys are affected
+  // by a layer change. The bitmaps are rebuilt automatically whenever `getKey`
+  // or `layer_count` change, but plugins that change the contents of a keymap
+  // need to let us know, either for a single entry, or for all of them:
+  static void updateLayerCoverage(uint8_t layer, KeyAddr key_addr);
+  static void updateLayerCoverage();
+
  private:
   using forEachHandler = void (*)(uint8_t index, uint8_t layer);
 
@@ -148,6 +169,16 @@ class Layer_ {
   static int8_t active_layers_[MAX_ACTIVE_LAYERS];
   static uint8_t active_layer_keymap_[kaleidoscope_internal::device.numKeys()];
 
+  static KeyAddrBitfield layer_coverage_[MAX_LAYER_COVERAGE];
+  static GetKeyFunction coverage_get_key_;
+  static uint8_t coverage_layer_count_;
+
+  static bool layerCoverageIsCurrent();
+  static bool coversKey(uint8_t layer, KeyAddr key_addr);
+  static uint8_t topLayerFor(KeyAddr key_addr);
+  static void raiseLayer(uint8_t layer);
+  static void lowerLayer(uint8_t layer);
+
   static int8_t stackPosition(uint8_t layer);
   static void remove(uint8_t stack_index);
   static uint8_t unshifted(uint8_t layer);
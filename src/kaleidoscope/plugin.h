@@ -26,8 +26,30 @@
 #error The V1 plugin API has been removed, please see UPGRADING.md.
 #endif
 
+#include <stdint.h>  // for uint16_t
+
+#include "kaleidoscope/key_defs.h"  // for Key
+
 namespace kaleidoscope {
 
+// A plugin whose `onKeyEvent()` and `onAddToReport()` handlers only ever act on
+// a range of `Key` values can declare that range, e.g.:
+//
+//   using KeyEventRange = KeyRange<ranges::MACRO_FIRST, ranges::MACRO_LAST>;
+//
+// The hook dispatch code will then skip calling those two handlers for keys
+// outside the (inclusive) range, without a function call. Only declare a range
+// if the handlers return `OK` without doing anything else for every other key.
+template<uint16_t _first, uint16_t _last>
+struct KeyRange {
+  static constexpr uint16_t first = _first;
+  static constexpr uint16_t last  = _last;
+
+  static constexpr bool contains(Key key) {
+    return key >= _first && key <= _last;
+  }
+};
+
 class Plugin {
 
  public:
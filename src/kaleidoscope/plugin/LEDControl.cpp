@@ -232,6 +232,11 @@ EventHandlerResult LEDControl::afterEachCycle() {
     update();
   }
 
+  // LED effects are animated in the cycles above, so tickless idle mode must
+  // not sleep through the next one.
+  uint16_t elapsed_time = Runtime.millisAtCycleStart() - last_sync_time_;
+  Runtime.limitIdleTime(elapsed_time < sync_interval_ ? sync_interval_ - elapsed_time : 0);
+
   return EventHandlerResult::OK;
 }
 
@@ -109,6 +109,8 @@ class LEDControl : public kaleidoscope::Plugin {
   }
 
   EventHandlerResult onSetup();
+  using KeyEventRange = KeyRange<(SYNTHETIC | IS_INTERNAL | LED_TOGGLE) << 8,
+                                 ((SYNTHETIC | IS_INTERNAL | LED_TOGGLE) << 8) | 0xff>;
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult afterEachCycle();
 
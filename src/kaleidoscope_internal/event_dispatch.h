@@ -41,9 +41,13 @@
 
 #pragma once
 
+#include "kaleidoscope/KeyEvent.h"                                        // for KeyEvent
 #include "kaleidoscope/event_handlers.h"                                  // for _FOR_EACH_EVENT...
+#include "kaleidoscope/hook_profile.h"                                    // for _INIT_HOOK_PROFILE
+#include "kaleidoscope/key_defs.h"                                        // for Key
+#include "kaleidoscope/latency_histogram.h"                               // for _INIT_LATENCY_HI...
 #include "kaleidoscope/macro_helpers.h"                                   // for __NL__, UNWRAP
-#include "kaleidoscope/plugin.h"  // IWYU pragma: keep
+#include "kaleidoscope/plugin.h"                                          // IWYU pragma: keep
 #include "kaleidoscope_internal/eventhandler_signature_check.h"           // for _PREPARE_EVENT_...
 #include "kaleidoscope_internal/sketch_exploration/plugin_exploration.h"  // for _INIT_PLUGIN_EX...
 #include "kaleidoscope_internal/sketch_exploration/sketch_exploration.h"  // IWYU pragma: keep
@@ -74,6 +78,63 @@
 // helper class to cast an associated EventHandler on each plugin instance.
 
 
+// Plugins can declare the range of keys that their onKeyEvent() and
+// onAddToReport() handlers act on (see kaleidoscope::KeyRange). For those two
+// hooks, the dispatch code checks the key against that range before calling
+// the plugin's handler. As the check happens right before each plugin's turn,
+// a change to the event's key by an earlier plugin is taken into account, and
+// the order in which plugins are called is the same as without the filter.
+
+namespace kaleidoscope_internal {
+
+template<typename T__>
+struct ToVoid {
+  typedef void Type;
+};
+
+template<typename Plugin__, typename = void>
+struct PluginDeclaresKeyEventRange {
+  static constexpr bool value = false;
+};
+
+template<typename Plugin__>
+struct PluginDeclaresKeyEventRange<
+  Plugin__, typename ToVoid<typename Plugin__::KeyEventRange>::Type> {
+  static constexpr bool value = true;
+};
+
+constexpr bool hookNamesMatch(const char *name1, const char *name2) {
+  return (*name1 == *name2) &&
+         (*name1 == '\0' || hookNamesMatch(name1 + 1, name2 + 1));
+}
+
+constexpr bool hookIsFilteredByKey(const char *hook_name) {
+  return hookNamesMatch(hook_name, "onKeyEvent") ||
+         hookNamesMatch(hook_name, "onAddToReport");
+}
+
+template<bool filter__, typename Plugin__>
+struct KeyEventFilter {
+  template<typename... Args__>
+  static constexpr bool accepts(Args__ &&...) {
+    return true;
+  }
+};
+
+template<typename Plugin__>
+struct KeyEventFilter<true, Plugin__> {
+  typedef typename Plugin__::KeyEventRange Range;
+
+  static constexpr bool accepts(const kaleidoscope::KeyEvent &event) {
+    return Range::contains(event.key);
+  }
+  static constexpr bool accepts(kaleidoscope::Key key) {
+    return Range::contains(key);
+  }
+};
+
+}  // namespace kaleidoscope_internal
+
 // This defines an auxiliary class 'EventHandler_Foo' for each hook 'Foo'.
 // Kaleidoscope::Hooks calls the EventDispatcher class, which in turn invokes
 // the event handler method 'Foo' of each registered plugin with a given
@@ -128,6 +189,16 @@
         return SHOULD_EXIT_IF_RESULT_NOT_OK;                              __NL__ \
       }                                                                   __NL__ \
                                                                           __NL__ \
+      static constexpr kaleidoscope::hook_profile::Hook hook() {          __NL__ \
+        return kaleidoscope::hook_profile::HOOK_NAME;                     __NL__ \
+      }                                                                   __NL__ \
+                                                                          __NL__ \
+      template<typename Plugin__>                                         __NL__ \
+      static constexpr bool isImplementedBy() {                           __NL__ \
+        return HookVersionImplemented_##HOOK_NAME<                        __NL__ \
+                 Plugin__, HOOK_VERSION>::value;                          __NL__ \
+      }                                                                   __NL__ \
+                                                                          __NL__ \
       template<typename Plugin__,                                         __NL__ \
                typename... Args__>                                        __NL__ \
       static kaleidoscope::EventHandlerResult                             __NL__ \
@@ -139,6 +210,16 @@
             = HookVersionImplemented_##HOOK_NAME<                         __NL__ \
                  Plugin__, HOOK_VERSION>::value;                          __NL__ \
                                                                           __NL__ \
+         static constexpr bool filter_by_key                              __NL__ \
+            = derived_implements_hook                                     __NL__ \
+              && hookIsFilteredByKey(#HOOK_NAME)                          __NL__ \
+              && PluginDeclaresKeyEventRange<Plugin__>::value;            __NL__ \
+                                                                          __NL__ \
+         if (!KeyEventFilter<filter_by_key, Plugin__>                     __NL__ \
+                ::accepts(hook_args...)) {                                __NL__ \
+            return kaleidoscope::EventHandlerResult::OK;                  __NL__ \
+         }                                                                __NL__ \
+                                                                          __NL__ \
          /* The caller type adds another level of indirection that */     __NL__ \
          /* is required to enable some hooks not to be implemented */     __NL__ \
          /* by plugins.                                            */     __NL__ \
@@ -182,9 +263,22 @@
                                                                           __NL__ \
    }
 
+// In profiling builds, each call is timed, and recorded under the plugin's
+// position in the list given to KALEIDOSCOPE_INIT_PLUGINS().
+#if KALEIDOSCOPE_HOOK_PROFILING
+#define _HOOK_PROFILE_PLUGIN_INDEX uint8_t plugin_index = 0;
+#define _CALL_EVENT_HANDLER_FOR_PLUGIN(PLUGIN)                              \
+   kaleidoscope::hook_profile::profiledCall<EventHandler__>(         __NL__ \
+      plugin_index++, PLUGIN, hook_args...)
+#else
+#define _HOOK_PROFILE_PLUGIN_INDEX
+#define _CALL_EVENT_HANDLER_FOR_PLUGIN(PLUGIN)                              \
+   EventHandler__::call(PLUGIN, hook_args...)
+#endif
+
 #define _INLINE_EVENT_HANDLER_FOR_PLUGIN(PLUGIN)                            \
                                                                      __NL__ \
-   result = EventHandler__::call(PLUGIN, hook_args...);              __NL__ \
+   result = _CALL_EVENT_HANDLER_FOR_PLUGIN(PLUGIN);                  __NL__ \
                                                                      __NL__ \
    if (EventHandler__::shouldExitIfResultNotOk() &&                  __NL__ \
        result != kaleidoscope::EventHandlerResult::OK) {             __NL__ \
@@ -211,6 +305,7 @@
     static kaleidoscope::EventHandlerResult apply(Args__&&... hook_args) {    __NL__ \
                                                                               __NL__ \
       kaleidoscope::EventHandlerResult result;                                __NL__ \
+      _HOOK_PROFILE_PLUGIN_INDEX                                              __NL__ \
       MAP(_INLINE_EVENT_HANDLER_FOR_PLUGIN, __VA_ARGS__)                      __NL__ \
                                                                               __NL__ \
       return result;                                                          __NL__ \
@@ -236,4 +331,7 @@
   /* LEDModeFactory entries                                                */ __NL__ \
   _INIT_LED_MODE_MANAGER(__VA_ARGS__)                                         __NL__ \
                                                                               __NL__ \
-  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)
+  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)                                       __NL__ \
+                                                                              __NL__ \
+  _INIT_HOOK_PROFILE(__VA_ARGS__)                                             __NL__ \
+  _INIT_LATENCY_HISTOGRAM()
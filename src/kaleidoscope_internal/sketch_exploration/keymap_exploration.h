@@ -24,8 +24,9 @@
 
 #include <stdint.h>  // for uint8_t
 
-#include "kaleidoscope/KeyAddr.h"   // for KeyAddr
-#include "kaleidoscope/key_defs.h"  // for Key, Key_NoKey
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"  // for bitfieldSize
+#include "kaleidoscope/key_defs.h"         // for Key, Key_NoKey, Key_Transparent
 
 namespace kaleidoscope {        // NOLINT(build/namespaces)
 namespace sketch_exploration {  // NOLINT(build/namespaces)
@@ -175,8 +176,51 @@ struct HasKey {
   Key k_;
 };
 
+// Tables computed from the keymap at compile time, to be stored in PROGMEM:
+// for each layer, a bitmap of the keys that are not transparent (with the same
+// layout as a `KeyAddrBitfield`).
+//
+template<uint8_t _n_layers, uint8_t _layer_size>
+struct KeymapSummary {
+  static constexpr uint8_t n_layers      = _n_layers;
+  static constexpr uint8_t coverage_size = bitfieldSize(_layer_size);
+
+  uint8_t coverage[_n_layers][coverage_size];
+
+  explicit constexpr KeymapSummary(const KeymapAdaptor<_n_layers, _layer_size> &keymap)
+    : coverage{} {
+    for (uint8_t layer = 0; layer < _n_layers; ++layer) {
+      for (uint8_t offset = 0; offset < _layer_size; ++offset) {
+        if (keymap.getKey(layer, offset) != Key_Transparent)
+          coverage[layer][offset / 8] |= (1 << (offset % 8));
+      }
+    }
+  }
+
+  const uint8_t *layerCoverage(uint8_t layer) const {
+    return (layer < _n_layers) ? coverage[layer] : nullptr;
+  }
+};
+
+// A special case for empty keymaps that makes the compiler happy.
+//
+struct EmptyKeymapSummary {
+  static constexpr uint8_t n_layers = 0;
+
+  const uint8_t *layerCoverage(uint8_t layer) const {
+    return nullptr;
+  }
+};
+
 extern void pluginsExploreSketch();
 
+// Runtime access to the `KeymapSummary` of the sketch's PROGMEM keymap (see
+// `_INIT_KEYMAP_EXPLORATION`). `progmemLayerCoverage()` returns a pointer to
+// the layer's coverage bitmap in PROGMEM, or `nullptr` if the layer doesn't
+// exist.
+//
+extern const uint8_t *progmemLayerCoverage(uint8_t layer);
+
 //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 // Read carefully
 //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -232,6 +276,15 @@ extern void pluginsExploreSketch();
           -> KeymapAdaptor<_n_layers, _layer_size>                             \
         {                                                                      \
           return KeymapAdaptor<_n_layers, _layer_size>{keymap};                \
+        }                                                                      \
+                                                                               \
+        template<int _n_layers, int _layer_size>                               \
+        static constexpr auto keymapSummary(                                   \
+                  const Key (&keymap)[_n_layers][_layer_size])                 \
+          -> KeymapSummary<_n_layers, _layer_size>                             \
+        {                                                                      \
+          return KeymapSummary<_n_layers, _layer_size>{                        \
+                   KeymapAdaptor<_n_layers, _layer_size>{keymap}};             \
         }                                                                      \
     };                                                                         \
                                                                                \
@@ -251,6 +304,13 @@ extern void pluginsExploreSketch();
           -> EmptyKeymapAdaptor                                                \
         {                                                                      \
           return EmptyKeymapAdaptor{};                                         \
+        }                                                                      \
+                                                                               \
+        template<typename _Keymap>                                             \
+        static constexpr auto keymapSummary(const _Keymap &)                   \
+          -> EmptyKeymapSummary                                                \
+        {                                                                      \
+          return EmptyKeymapSummary{};                                         \
         }                                                                      \
     };                                                                         \
                                                                                \
@@ -296,8 +356,22 @@ extern void pluginsExploreSketch();
         }                                                                      \
         static constexpr uint8_t layerSize() {                                 \
            return SKH::keymapAdaptor(::keymaps_linear).layer_size;             \
+        }                                                                      \
+                                                                               \
+        /* COMPILE_TIME_USE_ONLY (see explanation above)                       \
+         */                                                                    \
+        static constexpr auto summary()                                        \
+               -> decltype(SKH::keymapSummary(::keymaps_linear))               \
+        {                                                                      \
+           return SKH::keymapSummary(::keymaps_linear);                        \
         }                                                                      \
     };                                                                         \
+                                                                               \
+    constexpr auto keymap_summary PROGMEM = StaticKeymap::summary();           \
+                                                                               \
+    const uint8_t *progmemLayerCoverage(uint8_t layer) {                       \
+      return keymap_summary.layerCoverage(layer);                              \
+    }                                                                          \
   } /* namespace sketch_exploration */                                         \
   } /* namespace kaleidoscope */
 
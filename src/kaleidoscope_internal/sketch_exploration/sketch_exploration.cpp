@@ -20,6 +20,10 @@
  * this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope_internal/sketch_exploration/keymap_exploration.h"  // for progmemLayerCoverage
+
 namespace kaleidoscope {
 namespace sketch_exploration {
 
@@ -28,5 +32,11 @@ namespace sketch_exploration {
 //
 __attribute__((weak)) void pluginsExploreSketch() {}
 
+// Without a KEYMAP(...), there are no tables for the PROGMEM keymap.
+//
+__attribute__((weak)) const uint8_t *progmemLayerCoverage(uint8_t layer) {
+  return nullptr;
+}
+
 }  // namespace sketch_exploration
 }  // namespace kaleidoscope
@@ -59,6 +59,20 @@ void SimHarness::Release(KeyAddr key_addr) {
     kaleidoscope::Device::Props::KeyScanner::KeyState::NotPressed);
 }
 
+void SimHarness::PressAt(KeyAddr key_addr, uint32_t timestamp) {
+  kaleidoscope::Runtime.device().keyScanner().setKeystate(
+    key_addr,
+    kaleidoscope::Device::Props::KeyScanner::KeyState::Pressed,
+    timestamp);
+}
+
+void SimHarness::ReleaseAt(KeyAddr key_addr, uint32_t timestamp) {
+  kaleidoscope::Runtime.device().keyScanner().setKeystate(
+    key_addr,
+    kaleidoscope::Device::Props::KeyScanner::KeyState::NotPressed,
+    timestamp);
+}
+
 void SimHarness::Press(uint8_t row, uint8_t col) {
   Press(KeyAddr{row, col});
 }
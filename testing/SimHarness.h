@@ -17,7 +17,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <cstdint>  // for uint8_t
+#include <cstdint>  // for uint8_t, uint32_t
 #include <vector>
 #include <string>
 
@@ -36,6 +36,10 @@ class SimHarness {
   void Release(KeyAddr key_addr);
   void Press(uint8_t row, uint8_t col);
   void Release(uint8_t row, uint8_t col);
+  // Press or release a key, with the event carrying the given detection time
+  // (a `micros()` value), as a key scanner with its own timestamps would.
+  void PressAt(KeyAddr key_addr, uint32_t timestamp);
+  void ReleaseAt(KeyAddr key_addr, uint32_t timestamp);
   void SetCycleTime(uint8_t millis);
   uint8_t CycleTime() const;
 
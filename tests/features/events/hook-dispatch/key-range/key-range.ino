@@ -0,0 +1,101 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+
+#include <string>
+#include <vector>
+
+// A record of every hook call made to the plugins below, in order.
+std::vector<std::string> hook_calls;
+
+namespace kaleidoscope {
+namespace plugin {
+
+// Turns `Key_A` into `Key_F2`, which is in `RangedPlugin`'s range.
+class RemapPlugin : public Plugin {
+ public:
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    hook_calls.push_back("remap");
+    if (event.key == Key_A)
+      event.key = Key_F2;
+    return EventHandlerResult::OK;
+  }
+};
+
+// Only acts on `Key_F1` through `Key_F4`, and stops processing of `Key_F4`.
+class RangedPlugin : public Plugin {
+ public:
+  using KeyEventRange = KeyRange<Key_F1.getRaw(), Key_F4.getRaw()>;
+
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    hook_calls.push_back("ranged:" + std::to_string(event.key.getRaw()));
+    if (event.key == Key_F4)
+      return EventHandlerResult::ABORT;
+    return EventHandlerResult::OK;
+  }
+  EventHandlerResult onAddToReport(Key key) {
+    hook_calls.push_back("report:" + std::to_string(key.getRaw()));
+    return EventHandlerResult::OK;
+  }
+};
+
+// Declares no range, so it gets called for every key.
+class TailPlugin : public Plugin {
+ public:
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    hook_calls.push_back("tail");
+    return EventHandlerResult::OK;
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::RemapPlugin RemapPlugin;
+kaleidoscope::plugin::RangedPlugin RangedPlugin;
+kaleidoscope::plugin::TailPlugin TailPlugin;
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, Key_B, Key_F1, Key_F4, Key_F5, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(RemapPlugin, RangedPlugin, TailPlugin);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -0,0 +1,77 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string, to_string
+#include <vector>  // for vector
+
+#include "testing/setup-googletest.h"
+
+extern std::vector<std::string> hook_calls;
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using Calls = std::vector<std::string>;
+
+std::string raw(Key key) {
+  return std::to_string(key.getRaw());
+}
+
+class KeyRangeDispatch : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    hook_calls.clear();
+  }
+
+  Calls TapAndCollect(KeyAddr key_addr) {
+    hook_calls.clear();
+    sim_.Press(key_addr);
+    RunCycle();
+    Calls calls = hook_calls;
+    sim_.Release(key_addr);
+    RunCycle();
+    hook_calls.clear();
+    return calls;
+  }
+};
+
+TEST_F(KeyRangeDispatch, KeysOutsideTheRangeSkipThePlugin) {
+  EXPECT_EQ(TapAndCollect(KeyAddr{0, 1}), (Calls{"remap", "tail"}));
+  EXPECT_EQ(TapAndCollect(KeyAddr{0, 4}), (Calls{"remap", "tail"}));
+}
+
+TEST_F(KeyRangeDispatch, KeysInsideTheRangeKeepTheCallOrder) {
+  EXPECT_EQ(TapAndCollect(KeyAddr{0, 2}),
+            (Calls{"remap", "ranged:" + raw(Key_F1), "tail", "report:" + raw(Key_F1)}));
+}
+
+TEST_F(KeyRangeDispatch, RangeIsCheckedAfterEarlierPlugins) {
+  EXPECT_EQ(TapAndCollect(KeyAddr{0, 0}),
+            (Calls{"remap", "ranged:" + raw(Key_F2), "tail", "report:" + raw(Key_F2)}));
+}
+
+TEST_F(KeyRangeDispatch, AbortStillStopsLaterPlugins) {
+  EXPECT_EQ(TapAndCollect(KeyAddr{0, 3}),
+            (Calls{"remap", "ranged:" + raw(Key_F4)}));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,221 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>  // for rand, srand
+#include <deque>    // for deque
+
+#include "kaleidoscope/KeyAddrEventQueue.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+KeyEvent press(uint8_t key_index) {
+  return KeyEvent::next(KeyAddr(key_index), IS_PRESSED);
+}
+
+KeyEvent release(uint8_t key_index) {
+  return KeyEvent::next(KeyAddr(key_index), WAS_PRESSED);
+}
+
+// A copy of an entry, for comparing against a reference queue.
+struct Entry {
+  KeyEventId id;
+  KeyAddr addr;
+  bool release;
+
+  bool operator==(const Entry &other) const {
+    return id == other.id && addr == other.addr && release == other.release;
+  }
+};
+
+template<typename _Queue>
+std::deque<Entry> contents(const _Queue &queue) {
+  std::deque<Entry> entries;
+  for (uint8_t i{0}; i < queue.length(); ++i)
+    entries.push_back({queue.id(i), queue.addr(i), queue.isRelease(i)});
+  return entries;
+}
+
+Entry entry(const KeyEvent &event) {
+  return {event.id(), event.addr, keyToggledOff(event.state)};
+}
+
+class KeyAddrEventQueueTest : public VirtualDeviceTest {};
+
+TEST_F(KeyAddrEventQueueTest, AppendAndRead) {
+  KeyAddrEventQueue<4> queue;
+  EXPECT_TRUE(queue.isEmpty());
+
+  KeyEvent a = press(1), b = release(1);
+  queue.append(a);
+  queue.append(b);
+
+  ASSERT_EQ(queue.length(), 2);
+  EXPECT_EQ(queue.id(0), a.id());
+  EXPECT_EQ(queue.addr(0), KeyAddr(uint8_t(1)));
+  EXPECT_TRUE(queue.isPress(0));
+  EXPECT_EQ(queue.id(1), b.id());
+  EXPECT_TRUE(queue.isRelease(1));
+  EXPECT_EQ(queue.timestamp(1), uint16_t(Runtime.millisAtCycleStart()));
+
+  KeyEvent copy = queue.event(1);
+  EXPECT_EQ(copy.id(), b.id());
+  EXPECT_EQ(copy.addr, b.addr);
+  EXPECT_TRUE(keyToggledOff(copy.state));
+}
+
+TEST_F(KeyAddrEventQueueTest, KeepsOrderAcrossTheEndOfTheBuffer) {
+  KeyAddrEventQueue<4> queue;
+  std::deque<Entry> expected;
+
+  for (uint8_t n{0}; n < 20; ++n) {
+    KeyEvent event = (n % 3) ? press(n) : release(n);
+    queue.append(event);
+    expected.push_back(entry(event));
+    if (queue.isFull()) {
+      queue.shift();
+      expected.pop_front();
+    }
+    ASSERT_EQ(contents(queue), expected) << "after event " << int(n);
+  }
+}
+
+TEST_F(KeyAddrEventQueueTest, ShiftManyMovesEverything) {
+  KeyAddrEventQueue<8> queue;
+  KeyEvent events[5] = {press(1), press(2), release(1), press(3), release(2)};
+  for (const KeyEvent &event : events)
+    queue.append(event);
+
+  queue.shift(3);
+
+  ASSERT_EQ(queue.length(), 2);
+  EXPECT_EQ(queue.id(0), events[3].id());
+  EXPECT_EQ(queue.addr(0), events[3].addr);
+  EXPECT_TRUE(queue.isPress(0));
+  EXPECT_EQ(queue.id(1), events[4].id());
+  EXPECT_TRUE(queue.isRelease(1));
+
+  // `shouldAbort()` compares against the id of the new head of the queue.
+  EXPECT_FALSE(queue.shouldAbort(events[2]));
+  EXPECT_TRUE(queue.shouldAbort(events[3]));
+
+  queue.shift(2);
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(KeyAddrEventQueueTest, RemoveFromTheMiddle) {
+  KeyAddrEventQueue<8> queue;
+  std::deque<Entry> expected;
+  // Start with the head part way through the buffer.
+  for (uint8_t n{0}; n < 6; ++n)
+    queue.append(press(n));
+  queue.shift(6);
+
+  for (uint8_t n{0}; n < 7; ++n) {
+    KeyEvent event = (n % 2) ? release(n) : press(n);
+    queue.append(event);
+    expected.push_back(entry(event));
+  }
+
+  // One entry near the head, and one near the tail.
+  queue.remove(1);
+  expected.erase(expected.begin() + 1);
+  EXPECT_EQ(contents(queue), expected);
+
+  queue.remove(4);
+  expected.erase(expected.begin() + 4);
+  EXPECT_EQ(contents(queue), expected);
+
+  // Out of range; nothing happens.
+  queue.remove(5);
+  EXPECT_EQ(contents(queue), expected);
+}
+
+TEST_F(KeyAddrEventQueueTest, MatchesAReferenceQueue) {
+  KeyAddrEventQueue<16, uint16_t> queue;
+  std::deque<Entry> expected;
+  srand(1);
+
+  for (int n{0}; n < 2000; ++n) {
+    int op = rand() % 8;
+    if (op < 4 && !queue.isFull()) {
+      KeyEvent event = (op % 2) ? release(n % 64) : press(n % 64);
+      queue.append(event);
+      expected.push_back(entry(event));
+    } else if (op == 4 && !queue.isEmpty()) {
+      queue.shift();
+      expected.pop_front();
+    } else if (op == 5 && !queue.isEmpty()) {
+      uint8_t count = rand() % (queue.length() + 1);
+      queue.shift(count);
+      expected.erase(expected.begin(), expected.begin() + count);
+    } else if (op == 6 && !queue.isEmpty()) {
+      uint8_t index = rand() % queue.length();
+      queue.remove(index);
+      expected.erase(expected.begin() + index);
+    } else if (op == 7 && rand() % 16 == 0) {
+      queue.clear();
+      expected.clear();
+    }
+    ASSERT_EQ(contents(queue), expected) << "after operation " << n;
+  }
+}
+
+// Push events through a full queue the way a plugin does while keys roll over,
+// for several laps around the buffer, checking after each one that the queue
+// holds the most recent `_capacity` events in order.
+template<uint8_t _capacity, typename _Bitfield>
+void checkRollover() {
+  KeyAddrEventQueue<_capacity, _Bitfield> queue;
+  std::deque<Entry> expected;
+
+  for (uint16_t n{0}; n < 5 * _capacity + 3; ++n) {
+    if (queue.isFull()) {
+      queue.shift();
+      expected.pop_front();
+    }
+    KeyEvent event = (n % 2) ? release(n % 64) : press(n % 64);
+    queue.append(event);
+    expected.push_back(entry(event));
+
+    ASSERT_EQ(queue.length(), expected.size()) << "after event " << n;
+    ASSERT_EQ(contents(queue), expected) << "after event " << n;
+  }
+  EXPECT_TRUE(queue.isFull());
+
+  // Shifting half of a wrapped queue leaves the newer half at the head.
+  queue.shift(_capacity / 2);
+  expected.erase(expected.begin(), expected.begin() + _capacity / 2);
+  EXPECT_EQ(queue.length(), _capacity - _capacity / 2);
+  EXPECT_EQ(contents(queue), expected);
+
+  queue.shift(queue.length());
+  EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(KeyAddrEventQueueTest, Rollover) {
+  checkRollover<8, uint8_t>();
+  checkRollover<16, uint16_t>();
+  checkRollover<32, uint32_t>();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
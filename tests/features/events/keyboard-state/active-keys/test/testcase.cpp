@@ -0,0 +1,141 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The keys used in the sketch's keymap. Row 1, column 4 (`ShiftToLayer(2)`)
+// targets a layer that doesn't exist, so its `live_keys` entry gets masked.
+constexpr KeyAddr test_keys[] = {
+  {0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5}, {0, 6},
+  {1, 0}, {1, 1}, {1, 2}, {1, 3}, {1, 4}, {1, 5}, {1, 6},
+  {2, 0}, {3, 15}};
+
+class ActiveKeys : public VirtualDeviceTest {
+ protected:
+  // Build the set of Keyboard keycodes that a report should contain, the way
+  // `Runtime.prepareKeyboardReport()` used to: by checking every entry in the
+  // `live_keys` array, rather than just the ones flagged as active.
+  std::vector<uint8_t> FullScanKeycodes() const {
+    const LiveKeys &keys = live_keys;
+    std::set<uint8_t> keycodes;
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      Key key = keys[key_addr];
+      if (key == Key_Inactive || key == Key_Masked)
+        continue;
+      if (key.isModLayerKey())
+        key = Key(Key_LeftControl.getRaw() + key.getKeyCode() % 8);
+      if (key.isKeyboardKey())
+        keycodes.insert(key.getKeyCode());
+    }
+    return std::vector<uint8_t>(keycodes.begin(), keycodes.end());
+  }
+
+  // Every entry that isn't `Key_Inactive` must have its bit set.
+  void CheckActiveKeysBitfield() const {
+    const LiveKeys &keys = live_keys;
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      if (keys[key_addr] != Key_Inactive) {
+        EXPECT_TRUE(keys.activeKeys().read(key_addr))
+          << "Active entry at " << int(key_addr.toInt()) << " isn't flagged";
+      }
+    }
+  }
+
+  void CheckLastReport(const std::unique_ptr<State> &state) const {
+    CheckActiveKeysBitfield();
+    auto reports = state->HIDReports()->Keyboard();
+    if (reports.empty())
+      return;
+    auto observed = reports.back().ActiveKeycodes();
+    std::sort(observed.begin(), observed.end());
+    EXPECT_EQ(observed, FullScanKeycodes());
+  }
+};
+
+TEST_F(ActiveKeys, ChordsMatchFullScan) {
+  // Press and release the test keys in a pseudo-random order, with several
+  // changes per cycle, so that keys on different layers, layer shifts, masked
+  // keys, and Consumer Control keys all end up held together.
+  uint32_t seed = 0x2545F491;
+  bool pressed[sizeof(test_keys) / sizeof(test_keys[0])] = {};
+
+  for (int cycle = 0; cycle < 2000; ++cycle) {
+    uint8_t changes = 1 + (cycle % 4);
+    for (uint8_t c = 0; c < changes; ++c) {
+      seed       = seed * 1103515245 + 12345;
+      uint8_t i  = (seed >> 16) % (sizeof(test_keys) / sizeof(test_keys[0]));
+      pressed[i] = !pressed[i];
+      if (pressed[i]) {
+        sim_.Press(test_keys[i]);
+      } else {
+        sim_.Release(test_keys[i]);
+      }
+    }
+    auto state = RunCycle();
+    CheckLastReport(state);
+  }
+
+  // Release everything.
+  for (KeyAddr key_addr : test_keys)
+    sim_.Release(key_addr);
+  auto state = RunCycle();
+  CheckLastReport(state);
+
+  const LiveKeys &keys = live_keys;
+  for (KeyAddr key_addr : keys.activeKeys()) {
+    EXPECT_NE(keys[key_addr], Key_Inactive);
+  }
+}
+
+TEST_F(ActiveKeys, StaleEntriesAreDropped) {
+  constexpr KeyAddr key_addr_A{0, 0};
+  constexpr KeyAddr key_addr_B{0, 1};
+
+  // Writing through the non-const subscript operator flags the entry, even if
+  // the value written is `Key_Inactive`.
+  live_keys[KeyAddr{2, 1}] = Key_Inactive;
+  const LiveKeys &keys     = live_keys;
+  EXPECT_TRUE(keys.activeKeys().read(KeyAddr{2, 1}));
+
+  // The next report that gets built drops the stale entry.
+  sim_.Press(key_addr_A);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_A.getKeyCode()));
+  EXPECT_FALSE(keys.activeKeys().read(KeyAddr{2, 1}));
+
+  sim_.Press(key_addr_B);
+  state = RunCycle();
+  CheckLastReport(state);
+
+  sim_.Release(key_addr_A);
+  sim_.Release(key_addr_B);
+  state = RunCycle();
+  CheckLastReport(state);
+  EXPECT_FALSE(keys.activeKeys().read(key_addr_A));
+  EXPECT_FALSE(keys.activeKeys().read(key_addr_B));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
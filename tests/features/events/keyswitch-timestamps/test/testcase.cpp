@@ -0,0 +1,127 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>  // for vector
+
+#include "testing/setup-googletest.h"
+
+struct EventTime {
+  uint32_t timestamp;
+  uint32_t millis_at_event;
+  uint32_t cycle_start;
+  uint32_t cycle_start_us;
+};
+extern std::vector<EventTime> event_times;
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// Each test starts 100ms in, with nothing logged yet, and ends with the key
+// released again.
+
+class KeyswitchTimestamps : public VirtualDeviceTest {
+ protected:
+  // A timestamp `ms` milliseconds before the start of the last cycle.
+  uint32_t MicrosAgo(uint32_t ms) {
+    return Runtime.microsAtCycleStart() - ms * 1000;
+  }
+};
+
+TEST_F(KeyswitchTimestamps, PlainEventsHaveNoTimestamp) {
+  sim_.RunForMillis(100);
+  event_times.clear();
+
+  sim_.Press(0, 0);  // A
+  RunCycle();
+
+  ASSERT_EQ(event_times.size(), 1);
+  EXPECT_EQ(event_times[0].timestamp, 0);
+  EXPECT_EQ(event_times[0].millis_at_event, event_times[0].cycle_start);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(KeyswitchTimestamps, ScannerTimestampsArePassedOn) {
+  sim_.RunForMillis(100);
+  event_times.clear();
+
+  uint32_t timestamp = MicrosAgo(10) + 500;
+  sim_.PressAt(KeyAddr(0, 0), timestamp);
+  RunCycle();
+
+  ASSERT_EQ(event_times.size(), 1);
+  const EventTime &event_time = event_times[0];
+  EXPECT_EQ(event_time.timestamp, timestamp);
+  uint32_t age_ms = (event_time.cycle_start_us - timestamp) / 1000;
+  EXPECT_EQ(event_time.millis_at_event, event_time.cycle_start - age_ms);
+  EXPECT_LT(event_time.millis_at_event, event_time.cycle_start - 9);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(KeyswitchTimestamps, LaterTimestampsCountFromTheCycleStart) {
+  sim_.RunForMillis(100);
+  event_times.clear();
+
+  sim_.PressAt(KeyAddr(0, 0), Runtime.microsAtCycleStart() + 100000);
+  RunCycle();
+
+  ASSERT_EQ(event_times.size(), 1);
+  EXPECT_EQ(event_times[0].millis_at_event, event_times[0].cycle_start);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(KeyswitchTimestamps, QueuedTimeoutsStartAtTheEvent) {
+  sim_.RunForMillis(100);
+  event_times.clear();
+
+  // The key has been held for 15ms by the time the event is handled, so
+  // AutoShift's 20ms timeout expires after about 5ms more, not 20ms.
+  sim_.PressAt(KeyAddr(0, 0), MicrosAgo(15));
+  RunCycle();
+
+  sim_.RunForMillis(10);
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+  EXPECT_TRUE(Runtime.hid().keyboard().isModifierKeyActive(Key_LeftShift));
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(KeyswitchTimestamps, PlainTimeoutsStartAtTheCycle) {
+  sim_.RunForMillis(100);
+  event_times.clear();
+
+  sim_.Press(0, 0);  // A
+  RunCycle();
+
+  sim_.RunForMillis(10);
+  EXPECT_FALSE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
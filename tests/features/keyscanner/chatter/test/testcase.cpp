@@ -0,0 +1,174 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/driver/keyscanner/ChatterMonitor.h"
+#include "kaleidoscope/driver/keyscanner/Debounce.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using device::virt::VirtualKeyScanner;
+using RowState     = VirtualKeyScanner::RowState;
+namespace debounce = driver::keyscanner::debounce;
+
+// -----------------------------------------------------------------------------
+// Chatter monitoring, with the default 20ms window. Each test clears the
+// counts the ones before it left behind first.
+
+VirtualKeyScanner::Debounced<debounce::Adaptive<RowState, 1, 4>> chatter_adaptive;
+
+class ChatterMonitor : public VirtualDeviceTest {
+ protected:
+  // Press and release `key_addr`, one cycle each, then press it again.
+  void Chatter(KeyAddr key_addr) {
+    sim_.Press(key_addr);
+    RunCycle();
+    sim_.Release(key_addr);
+    RunCycle();
+    sim_.Press(key_addr);
+    RunCycle();
+  }
+};
+
+TEST_F(ChatterMonitor, QuickRepressIsCounted) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  Chatter(KeyAddr(0, 0));
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 1);
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 1)), 0);
+
+  // The monitor only counts, the press still goes through.
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(ChatterMonitor, SlowRepressIsNotCounted) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(100);
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 0);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+}
+
+TEST_F(ChatterMonitor, OtherKeysDoNotCount) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  sim_.Release(0, 0);  // A
+  RunCycle();
+  sim_.Press(0, 1);  // B
+  RunCycle();
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 0);
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 1)), 0);
+
+  sim_.Release(0, 1);  // B
+  sim_.RunForMillis(50);
+}
+
+TEST_F(ChatterMonitor, ZeroWindowDisablesMonitoring) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  scanner.setChatterWindow(0);
+  Chatter(KeyAddr(0, 0));
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 0);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+  scanner.setChatterWindow(20);
+}
+
+TEST_F(ChatterMonitor, CanRaiseTheDebounceTime) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  scanner.setDebounceFilter(&chatter_adaptive);
+
+  // Without being asked to, the monitor leaves the debouncer alone.
+  Chatter(KeyAddr(0, 0));
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 1);
+  EXPECT_EQ(chatter_adaptive.row(0).threshold(0), 1);
+
+  sim_.Release(0, 0);  // A
+  sim_.RunForMillis(50);
+  scanner.setChatterRaisesDebounce(true);
+  Chatter(KeyAddr(0, 0));
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 0)), 2);
+  EXPECT_EQ(chatter_adaptive.row(0).threshold(0), 2);
+  EXPECT_EQ(chatter_adaptive.row(0).threshold(1), 1);
+
+  // Clean changes don't lower the threshold below the raised minimum.
+  sim_.Release(0, 0);  // A
+  sim_.RunCycles(4);
+  EXPECT_FALSE(scanner.isKeyswitchPressed(KeyAddr(0, 0)));
+  EXPECT_EQ(chatter_adaptive.row(0).threshold(0), 2);
+
+  sim_.RunForMillis(50);
+  scanner.setChatterRaisesDebounce(false);
+  scanner.setDebounceFilter(nullptr);
+}
+
+TEST_F(ChatterMonitor, FocusCommands) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.resetChatterCounts();
+  Chatter(KeyAddr(0, 1));
+  Chatter(KeyAddr(0, 1));
+
+  std::string response = sim_.SendFocusCommand("hardware.chatter");
+  EXPECT_NE(response.find("0 1 2"), std::string::npos) << response;
+  EXPECT_EQ(response.find("0 0 "), std::string::npos) << response;
+
+  response = sim_.SendFocusCommand("hardware.chatter.window");
+  EXPECT_NE(response.find("20"), std::string::npos) << response;
+  sim_.SendFocusCommand("hardware.chatter.window 5");
+  EXPECT_EQ(scanner.chatterWindow(), 5);
+
+  sim_.SendFocusCommand("hardware.chatter.reset");
+  EXPECT_EQ(scanner.chatterCount(KeyAddr(0, 1)), 0);
+
+  sim_.Release(0, 1);  // B
+  sim_.RunForMillis(50);
+  scanner.setChatterWindow(20);
+}
+
+TEST(ChatterMonitorStorage, LeftOutWithoutKeys) {
+  typedef driver::keyscanner::ChatterMonitor<0> NoMonitor;
+  static_assert(sizeof(NoMonitor) == 1, "A monitor without keys takes no RAM");
+
+  NoMonitor monitor(20);
+  EXPECT_EQ(monitor.window(), 0);
+  EXPECT_FALSE(monitor.update(0, WAS_PRESSED, 0));
+  EXPECT_FALSE(monitor.update(0, IS_PRESSED, 1));
+  EXPECT_EQ(monitor.count(0), 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
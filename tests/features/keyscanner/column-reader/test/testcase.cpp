@@ -0,0 +1,175 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>  // for memset
+
+#include "kaleidoscope/driver/keyscanner/ColumnReader.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// -----------------------------------------------------------------------------
+// Reading the ATmega matrix columns a port at a time. These don't go through
+// the virtual device at all.
+
+using driver::keyscanner::ColumnReader;
+
+// `PINDEF()` is a dummy in the virtual build, so the pins are encoded here the
+// way it does on the ATmega32U4.
+constexpr uint8_t B = 0x3, C = 0x6, D = 0x9, E = 0xC, F = 0xF;
+
+constexpr uint8_t pin(uint8_t port, uint8_t bit) {
+  return (port << PORT_SHIFTER) | bit;
+}
+
+// The column pins of some of the boards that use the ATmega key scanner.
+struct Atreus2Props {
+  typedef uint16_t RowState;
+  static constexpr uint8_t matrix_columns                  = 12;
+  static constexpr uint8_t matrix_col_pins[matrix_columns] = {
+    pin(F, 7), pin(E, 2), pin(C, 7), pin(C, 6), pin(B, 6), pin(B, 5),
+    pin(D, 7), pin(D, 6), pin(D, 4), pin(D, 5), pin(D, 3), pin(D, 2)};
+};
+constexpr uint8_t Atreus2Props::matrix_col_pins[];
+
+struct TechnomancyAtreusProps {
+  typedef uint16_t RowState;
+  static constexpr uint8_t matrix_columns                  = 11;
+  static constexpr uint8_t matrix_col_pins[matrix_columns] = {
+    pin(D, 7), pin(C, 6), pin(B, 5), pin(B, 4), pin(E, 6), pin(D, 4),
+    pin(B, 6), pin(F, 6), pin(F, 7), pin(D, 6), pin(B, 7)};
+};
+constexpr uint8_t TechnomancyAtreusProps::matrix_col_pins[];
+
+struct ButterStickProps {
+  typedef uint16_t RowState;
+  static constexpr uint8_t matrix_columns                  = 10;
+  static constexpr uint8_t matrix_col_pins[matrix_columns] = {
+    pin(B, 0), pin(B, 1), pin(B, 2), pin(B, 3), pin(B, 4),
+    pin(B, 5), pin(B, 6), pin(B, 7), pin(C, 6), pin(C, 7)};
+};
+constexpr uint8_t ButterStickProps::matrix_col_pins[];
+
+// Port registers, with pull-ups: a pin reads high unless its key is pressed.
+struct FakePinRegister {
+  static uint8_t ports[16];
+  static uint32_t reads;
+
+  template<uint8_t _port>
+  static uint8_t read() {
+    ++reads;
+    return ports[_port];
+  }
+
+  static void releaseAll() {
+    memset(ports, 0xff, sizeof(ports));
+    reads = 0;
+  }
+  static void press(uint8_t pin) {
+    ports[pin >> PORT_SHIFTER] &= ~(1 << (pin & PIN_ADDRESS_MASK));
+  }
+};
+uint8_t FakePinRegister::ports[16];
+uint32_t FakePinRegister::reads;
+
+// What the ATmega key scanner used to do: read every column pin on its own.
+template<typename _Props>
+typename _Props::RowState readPinByPin() {
+  typename _Props::RowState hot_pins = 0;
+  for (uint8_t i = 0; i < _Props::matrix_columns; i++) {
+    uint8_t pin = _Props::matrix_col_pins[i];
+    ++FakePinRegister::reads;
+    bool high = FakePinRegister::ports[pin >> PORT_SHIFTER] & (1 << (pin & PIN_ADDRESS_MASK));
+    hot_pins |= typename _Props::RowState(!high) << i;
+  }
+  return hot_pins;
+}
+
+template<typename _Props>
+class ColumnReaderTest : public ::testing::Test {
+ protected:
+  typedef ColumnReader<_Props, FakePinRegister> Reader;
+};
+
+typedef ::testing::Types<Atreus2Props, TechnomancyAtreusProps, ButterStickProps> BoardProps;
+TYPED_TEST_SUITE(ColumnReaderTest, BoardProps);
+
+TYPED_TEST(ColumnReaderTest, NothingPressed) {
+  FakePinRegister::releaseAll();
+  EXPECT_EQ(TestFixture::Reader::read(), 0);
+}
+
+TYPED_TEST(ColumnReaderTest, EachColumnEndsUpInItsOwnBit) {
+  for (uint8_t col = 0; col < TypeParam::matrix_columns; col++) {
+    FakePinRegister::releaseAll();
+    FakePinRegister::press(TypeParam::matrix_col_pins[col]);
+    EXPECT_EQ(TestFixture::Reader::read(), 1 << col) << "column " << int(col);
+  }
+}
+
+TYPED_TEST(ColumnReaderTest, PinsThatAreNotColumnsAreIgnored) {
+  memset(FakePinRegister::ports, 0, sizeof(FakePinRegister::ports));
+  for (uint8_t col = 0; col < TypeParam::matrix_columns; col++) {
+    uint8_t pin = TypeParam::matrix_col_pins[col];
+    FakePinRegister::ports[pin >> PORT_SHIFTER] |= 1 << (pin & PIN_ADDRESS_MASK);
+  }
+  EXPECT_EQ(TestFixture::Reader::read(), 0);
+}
+
+TYPED_TEST(ColumnReaderTest, MatchesReadingPinByPin) {
+  // A cheap pseudo-random sequence of port states.
+  uint32_t seed = 12345;
+  for (uint16_t n = 0; n < 1000; n++) {
+    for (uint8_t &port : FakePinRegister::ports) {
+      seed = seed * 1103515245 + 12345;
+      port = seed >> 16;
+    }
+    ASSERT_EQ(TestFixture::Reader::read(), readPinByPin<TypeParam>());
+  }
+}
+
+TYPED_TEST(ColumnReaderTest, ReadsEachPortOnce) {
+  FakePinRegister::releaseAll();
+  TestFixture::Reader::read();
+  EXPECT_EQ(FakePinRegister::reads, TestFixture::Reader::portReads());
+}
+
+static_assert(ColumnReader<Atreus2Props, FakePinRegister>::portReads() == 5,
+              "The Atreus columns are on five ports");
+static_assert(ColumnReader<TechnomancyAtreusProps, FakePinRegister>::portReads() == 5,
+              "The Technomancy Atreus columns are on five ports");
+static_assert(ColumnReader<ButterStickProps, FakePinRegister>::portReads() == 2,
+              "The ButterStick columns are on two ports");
+
+// On every one of these boards, reading a port at a time takes fewer register
+// reads than reading the columns pin by pin did.
+TYPED_TEST(ColumnReaderTest, ReadsFewerRegistersThanPinByPin) {
+  FakePinRegister::releaseAll();
+  readPinByPin<TypeParam>();
+  uint32_t pin_by_pin_reads = FakePinRegister::reads;
+
+  FakePinRegister::releaseAll();
+  TestFixture::Reader::read();
+  EXPECT_LT(FakePinRegister::reads, pin_by_pin_reads);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,206 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/driver/keyscanner/Debounce.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using device::virt::VirtualKeyScanner;
+using RowState     = VirtualKeyScanner::RowState;
+namespace debounce = driver::keyscanner::debounce;
+
+// -----------------------------------------------------------------------------
+// Debouncing, with each of the bundled policies in turn.
+
+VirtualKeyScanner::Debounced<debounce::None<RowState>> no_debounce;
+VirtualKeyScanner::Debounced<debounce::Symmetric<RowState>> symmetric;
+VirtualKeyScanner::Debounced<debounce::EagerPress<RowState>> eager_press;
+VirtualKeyScanner::Debounced<debounce::Adaptive<RowState, 2, 4>> adaptive;
+
+class Debounce : public VirtualDeviceTest {
+ protected:
+  // Feed `samples` to the scanner, one per cycle, with `#` for a raw sample
+  // in which `key_addr` is pressed, and `.` for one in which it is released.
+  // Returns the debounced state of the key after each cycle, in the same
+  // format.
+  std::string Feed(const char *samples, KeyAddr key_addr = KeyAddr(0, 0)) {
+    std::string debounced;
+    for (const char *sample = samples; *sample != '\0'; ++sample) {
+      if (*sample == '#') {
+        sim_.Press(key_addr);
+      } else {
+        sim_.Release(key_addr);
+      }
+      RunCycle();
+      debounced += Runtime.device().keyScanner().isKeyswitchPressed(key_addr) ? '#' : '.';
+    }
+    return debounced;
+  }
+};
+
+TEST_F(Debounce, NoneCountsEverySample) {
+  Runtime.device().keyScanner().setDebounceFilter(&no_debounce);
+  EXPECT_EQ(Feed("#.##..#."),
+            /*  */ "#.##..#.");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, SymmetricChangesTakeFourScans) {
+  Runtime.device().keyScanner().setDebounceFilter(&symmetric);
+  EXPECT_EQ(Feed("######......"),
+            /*  */ "...######...");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, SymmetricIgnoresPressBounce) {
+  Runtime.device().keyScanner().setDebounceFilter(&symmetric);
+  EXPECT_EQ(Feed("#.#.####....#.#...."),
+            /*  */ ".......####........");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, SymmetricIgnoresReleaseBounce) {
+  Runtime.device().keyScanner().setDebounceFilter(&symmetric);
+  EXPECT_EQ(Feed("####.#.#....."),
+            /*  */ "...########..");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, SymmetricDebouncesKeysSeparately) {
+  Runtime.device().keyScanner().setDebounceFilter(&symmetric);
+  sim_.Press(0, 1);  // B
+  EXPECT_EQ(Feed("##.####...."),
+            /*  */ "......####.");
+  EXPECT_TRUE(Runtime.device().keyScanner().isKeyswitchPressed(KeyAddr(0, 1)));
+
+  sim_.Release(0, 1);  // B
+  sim_.RunCycles(4);
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, SymmetricReportsEventsOnceDebounced) {
+  Runtime.device().keyScanner().setDebounceFilter(&symmetric);
+  sim_.Press(0, 0);  // A
+  sim_.RunCycles(3);
+  EXPECT_FALSE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+  RunCycle();
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  sim_.RunCycles(4);
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, EagerPressPressesAreImmediate) {
+  Runtime.device().keyScanner().setDebounceFilter(&eager_press);
+  EXPECT_EQ(Feed("#####......."),
+            /*  */ "########....");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, EagerPressIgnoresPressBounce) {
+  Runtime.device().keyScanner().setDebounceFilter(&eager_press);
+  EXPECT_EQ(Feed("#.#.######......"),
+            /*  */ "#############...");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, EagerPressLocksOutReleaseBounce) {
+  Runtime.device().keyScanner().setDebounceFilter(&eager_press);
+  EXPECT_EQ(Feed("####....#.#......"),
+            /*  */ "#######..........");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, EagerPressDelaysPressesDuringLockout) {
+  Runtime.device().keyScanner().setDebounceFilter(&eager_press);
+  EXPECT_EQ(Feed("####....####......."),
+            /*  */ "#######....####....");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, EagerPressReportsEventsImmediately) {
+  Runtime.device().keyScanner().setDebounceFilter(&eager_press);
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  sim_.RunCycles(10);
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, AdaptiveCleanKeysUseTheMinimum) {
+  Runtime.device().keyScanner().setDebounceFilter(&adaptive);
+  EXPECT_EQ(Feed("####...."),
+            /*  */ ".####...");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 2);
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, AdaptiveBounceRaisesTheThreshold) {
+  Runtime.device().keyScanner().setDebounceFilter(&adaptive);
+  EXPECT_EQ(Feed("#."),
+            /*  */ "..");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 3);
+
+  // The press that follows the bounce doesn't lower the threshold, but the
+  // clean release after it does.
+  EXPECT_EQ(Feed("###"),
+            /*  */ "..#");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 3);
+  EXPECT_EQ(Feed("..."),
+            /*  */ "##.");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 2);
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, AdaptiveThresholdIsCapped) {
+  Runtime.device().keyScanner().setDebounceFilter(&adaptive);
+  EXPECT_EQ(Feed("#.#.#.#."),
+            /*  */ "........");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 4);
+  EXPECT_EQ(Feed("####"),
+            /*  */ "...#");
+
+  // A clean release brings the threshold back down.
+  EXPECT_EQ(Feed("........"),
+            /*  */ "###.....");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+TEST_F(Debounce, AdaptiveThresholdsArePerKey) {
+  Runtime.device().keyScanner().setDebounceFilter(&adaptive);
+  Feed("#.#.");
+  EXPECT_EQ(adaptive.row(0).threshold(0), 4);
+  EXPECT_EQ(adaptive.row(0).threshold(1), 2);
+  EXPECT_EQ(Feed("##..", KeyAddr(0, 1)),
+            /*  */ ".##.");
+
+  Feed("####........");
+  Runtime.device().keyScanner().setDebounceFilter(nullptr);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,87 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-OneShot.h>
+
+#include <string>
+#include <vector>
+
+// A record of the key event hooks called for the keys on the keymap, in order.
+std::vector<std::string> hook_calls;
+
+namespace kaleidoscope {
+namespace plugin {
+
+class HookRecorder : public Plugin {
+ public:
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    hook_calls.push_back("event:" + std::to_string(event.key.getKeyCode()));
+    return EventHandlerResult::OK;
+  }
+  EventHandlerResult afterReportingState(const KeyEvent &event) {
+    hook_calls.push_back("after:" + std::to_string(event.key.getKeyCode()));
+    return EventHandlerResult::OK;
+  }
+};
+
+// Turns `Key_H` into `Key_LeftControl`, like plugins that change the key of
+// an event in `onKeyEvent()` do.
+class KeyChanger : public Plugin {
+ public:
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    if (event.key == Key_H)
+      event.key = Key_LeftControl;
+    return EventHandlerResult::OK;
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::HookRecorder HookRecorder;
+kaleidoscope::plugin::KeyChanger KeyChanger;
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, Key_B, Key_LeftShift, LSHIFT(Key_1), Key_A, Key_C, Key_D,
+        Key_E, Key_F, Key_G, OSM(LeftShift), Key_H, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(OneShot, KeyChanger, HookRecorder);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
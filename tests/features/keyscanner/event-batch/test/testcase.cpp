@@ -0,0 +1,315 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <deque>   // for deque
+#include <string>  // for string, to_string
+#include <vector>  // for vector
+
+#include "kaleidoscope/driver/keyscanner/EventBatch.h"
+#include "testing/setup-googletest.h"
+
+extern std::vector<std::string> hook_calls;
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+// -----------------------------------------------------------------------------
+// The batch itself, with a host queue standing in for the FreeRTOS one.
+
+struct TestEvent {
+  uint8_t id;
+  uint32_t timestamp;
+};
+
+class EventBatchTest : public ::testing::Test {
+ protected:
+  uint8_t Drain() {
+    return batch_.drain([this](TestEvent &event) {
+      if (queue_.empty())
+        return false;
+      event = queue_.front();
+      queue_.pop_front();
+      return true;
+    });
+  }
+
+  std::vector<uint8_t> Ids() const {
+    std::vector<uint8_t> ids;
+    for (const TestEvent &event : batch_)
+      ids.push_back(event.id);
+    return ids;
+  }
+
+  std::deque<TestEvent> queue_;
+  driver::keyscanner::EventBatch<TestEvent, 4> batch_;
+};
+
+TEST_F(EventBatchTest, EmptyQueue) {
+  EXPECT_EQ(Drain(), 0);
+  EXPECT_EQ(batch_.size(), 0);
+}
+
+TEST_F(EventBatchTest, EventsAreSortedByTimestamp) {
+  queue_ = {{0, 300}, {1, 100}, {2, 200}};
+  EXPECT_EQ(Drain(), 3);
+  EXPECT_THAT(Ids(), ElementsAre(1, 2, 0));
+  EXPECT_TRUE(queue_.empty());
+}
+
+TEST_F(EventBatchTest, EventsWithTheSameTimestampKeepTheirOrder) {
+  // Like an encoder step, which queues a press and a release at once.
+  queue_ = {{0, 200}, {1, 100}, {2, 100}, {3, 100}};
+  Drain();
+  EXPECT_THAT(Ids(), ElementsAre(1, 2, 3, 0));
+}
+
+TEST_F(EventBatchTest, TimestampsWrapAround) {
+  queue_ = {{0, 0x10}, {1, 0xfffffff0}};
+  Drain();
+  EXPECT_THAT(Ids(), ElementsAre(1, 0));
+}
+
+TEST_F(EventBatchTest, EventsBeyondCapacityStayQueued) {
+  queue_ = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 6}};
+  EXPECT_EQ(Drain(), 4);
+  EXPECT_THAT(Ids(), ElementsAre(0, 1, 2, 3));
+  EXPECT_EQ(queue_.size(), 2);
+  EXPECT_EQ(Drain(), 2);
+  EXPECT_THAT(Ids(), ElementsAre(4, 5));
+}
+
+// -----------------------------------------------------------------------------
+// Coalescing the keyboard reports of a batch.
+
+// Each test turns batching on, and off again once its keys are released.
+
+class ReportBatch : public VirtualDeviceTest {
+ protected:
+  // Run a cycle, and return the keyboard reports sent in it.
+  std::vector<KeyboardReport> Reports() {
+    auto state = RunCycle();
+    return state->HIDReports()->Keyboard();
+  }
+};
+
+TEST_F(ReportBatch, ChordIsSentAsOneReport) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(0, 5);  // C
+  auto reports = Reports();
+  ASSERT_EQ(reports.size(), 1);
+  EXPECT_THAT(reports[0].ActiveKeycodes(),
+              UnorderedElementsAre(Key_A.getKeyCode(), Key_B.getKeyCode(), Key_C.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(0, 5);  // C
+  reports = Reports();
+  ASSERT_EQ(reports.size(), 1);
+  EXPECT_TRUE(reports[0].ActiveKeycodes().empty());
+
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, WithoutBatchingEveryEventIsReported) {
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  EXPECT_EQ(Reports().size(), 2);
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  RunCycle();
+}
+
+TEST_F(ReportBatch, PressesAndReleasesAreNotMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  RunCycle();
+
+  sim_.Release(0, 0);  // A
+  sim_.Press(0, 1);    // B
+  auto reports = Reports();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_TRUE(reports[0].ActiveKeycodes().empty());
+  EXPECT_THAT(reports[1].ActiveKeycodes(), ElementsAre(Key_B.getKeyCode()));
+
+  sim_.Release(0, 1);  // B
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, KeysAfterModifierAreMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 2);  // LeftShift
+  sim_.Press(0, 5);  // C
+  sim_.Press(0, 6);  // D
+  auto reports = Reports();
+
+  // The HID driver always sends a change of modifiers on its own first.
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_THAT(reports[0].ActiveKeycodes(), ElementsAre(Key_LeftShift.getKeyCode()));
+  EXPECT_THAT(reports[1].ActiveKeycodes(),
+              UnorderedElementsAre(Key_LeftShift.getKeyCode(), Key_C.getKeyCode(), Key_D.getKeyCode()));
+
+  sim_.Release(0, 2);  // LeftShift
+  sim_.Release(0, 5);  // C
+  sim_.Release(0, 6);  // D
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, ModifierAfterKeyIsNotMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 2);  // LeftShift
+  auto reports = Reports();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_THAT(reports[0].ActiveKeycodes(), ElementsAre(Key_A.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 2);  // LeftShift
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, KeysWithModifierFlagsAreNotMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 1);  // B
+  sim_.Press(0, 3);  // LSHIFT(Key_1)
+  auto reports = Reports();
+
+  // B on its own, then the modifier of `LSHIFT(Key_1)`, then its keycode.
+  ASSERT_EQ(reports.size(), 3);
+  EXPECT_THAT(reports[0].ActiveKeycodes(), ElementsAre(Key_B.getKeyCode()));
+  EXPECT_THAT(reports[1].ActiveKeycodes(),
+              UnorderedElementsAre(Key_LeftShift.getKeyCode(), Key_B.getKeyCode()));
+  EXPECT_THAT(reports[2].ActiveKeycodes(),
+              UnorderedElementsAre(Key_LeftShift.getKeyCode(), Key_B.getKeyCode(), Key_1.getKeyCode()));
+
+  sim_.Release(0, 1);  // B
+  sim_.Release(0, 3);  // LSHIFT(Key_1)
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, RepeatedKeycodesAreNotMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 4);  // A
+  auto reports = Reports();
+
+  // The same reports as without batching: A, then A released and pressed
+  // again for the second key.
+  ASSERT_EQ(reports.size(), 3);
+  EXPECT_THAT(reports[0].ActiveKeycodes(), ElementsAre(Key_A.getKeyCode()));
+  EXPECT_TRUE(reports[1].ActiveKeycodes().empty());
+  EXPECT_THAT(reports[2].ActiveKeycodes(), ElementsAre(Key_A.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 4);  // A
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, KeysChangedToModifiersAreNotMerged) {
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(1, 4);  // H, which becomes LeftControl
+  auto reports = Reports();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_THAT(reports[0].ActiveKeycodes(), ElementsAre(Key_A.getKeyCode()));
+  EXPECT_THAT(reports[1].ActiveKeycodes(),
+              UnorderedElementsAre(Key_A.getKeyCode(), Key_LeftControl.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(1, 4);  // H
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, OneShotModifierOnlyAppliesToTheNextKey) {
+  sim_.Press(1, 3);  // OSM(LeftShift)
+  RunCycle();
+  sim_.Release(1, 3);  // OSM(LeftShift)
+  RunCycle();
+
+  Runtime.device().keyScanner().setEventBatching(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  auto reports = Reports();
+
+  // OneShot releases the modifier once A's report is out, so that report gets
+  // sent before B can join it.
+  ASSERT_EQ(reports.size(), 3);
+  EXPECT_THAT(reports[0].ActiveKeycodes(),
+              UnorderedElementsAre(Key_LeftShift.getKeyCode(), Key_A.getKeyCode()));
+  EXPECT_THAT(reports[1].ActiveKeycodes(), ElementsAre(Key_A.getKeyCode()));
+  EXPECT_THAT(reports[2].ActiveKeycodes(),
+              UnorderedElementsAre(Key_A.getKeyCode(), Key_B.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+TEST_F(ReportBatch, AfterReportingStateIsCalledForEachEvent) {
+  const std::string a = std::to_string(Key_A.getKeyCode());
+  const std::string b = std::to_string(Key_B.getKeyCode());
+
+  Runtime.device().keyScanner().setEventBatching(true);
+  hook_calls.clear();
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  ASSERT_EQ(Reports().size(), 1);
+  EXPECT_THAT(hook_calls, ElementsAre("event:" + a, "after:" + a, "event:" + b, "after:" + b));
+
+  hook_calls.clear();
+  Runtime.device().keyScanner().setEventBatching(false);
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  ASSERT_EQ(Reports().size(), 2);
+  EXPECT_THAT(hook_calls, ElementsAre("event:" + a, "after:" + a, "event:" + b, "after:" + b));
+}
+
+TEST_F(ReportBatch, LongChordsAreSplit) {
+  Runtime.device().keyScanner().setEventBatching(true);
+
+  // Up to six events share a report, so that their latency can be recorded.
+  const KeyAddr chord[] = {{0, 0}, {0, 1}, {0, 5}, {0, 6}, {1, 0}, {1, 1}, {1, 2}};
+  for (KeyAddr key_addr : chord)
+    sim_.Press(key_addr);
+  auto reports = Reports();
+  ASSERT_EQ(reports.size(), 2);
+  EXPECT_EQ(reports[0].ActiveKeycodes().size(), 6);
+  EXPECT_EQ(reports[1].ActiveKeycodes().size(), 7);
+
+  for (KeyAddr key_addr : chord)
+    sim_.Release(key_addr);
+  RunCycle();
+  Runtime.device().keyScanner().setEventBatching(false);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,248 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/driver/keyscanner/GhostFilter.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::keyscanner::GhostFilter;
+
+// -----------------------------------------------------------------------------
+// The filter, on synthetic matrices.
+
+typedef GhostFilter<uint8_t, 4> Filter;
+
+template<size_t _rows>
+Filter detect(const uint8_t (&matrix)[_rows]) {
+  Filter ghosts;
+  ghosts.detect([&matrix](uint8_t row) {
+    return matrix[row];
+  });
+  return ghosts;
+}
+
+TEST(GhostFilter, RectangleIsAmbiguous) {
+  const uint8_t matrix[4] = {0b0101, 0, 0b0101, 0};
+  Filter ghosts           = detect(matrix);
+  EXPECT_EQ(ghosts.ambiguous(0), 0b0101);
+  EXPECT_EQ(ghosts.ambiguous(1), 0);
+  EXPECT_EQ(ghosts.ambiguous(2), 0b0101);
+  EXPECT_EQ(ghosts.ambiguous(3), 0);
+}
+
+TEST(GhostFilter, OtherKeysInTheRowsAreNot) {
+  const uint8_t matrix[4] = {0b1101, 0, 0b0111, 0b0010};
+  Filter ghosts           = detect(matrix);
+  EXPECT_EQ(ghosts.ambiguous(0), 0b0101);
+  EXPECT_EQ(ghosts.ambiguous(2), 0b0101);
+  EXPECT_EQ(ghosts.ambiguous(3), 0);
+}
+
+TEST(GhostFilter, ThreeCornersAreNotAmbiguous) {
+  const uint8_t matrix[4] = {0b0101, 0b0001, 0, 0};
+  Filter ghosts           = detect(matrix);
+  for (uint8_t row = 0; row < 4; row++)
+    EXPECT_EQ(ghosts.ambiguous(row), 0) << "row " << int(row);
+}
+
+TEST(GhostFilter, FullColumnsAreNotAmbiguous) {
+  const uint8_t matrix[4] = {0b0001, 0b0001, 0b0011, 0b0001};
+  Filter ghosts           = detect(matrix);
+  for (uint8_t row = 0; row < 4; row++)
+    EXPECT_EQ(ghosts.ambiguous(row), 0) << "row " << int(row);
+}
+
+TEST(GhostFilter, RectanglesCanOverlap) {
+  const uint8_t matrix[4] = {0b0011, 0b0111, 0b0110, 0};
+  Filter ghosts           = detect(matrix);
+  EXPECT_EQ(ghosts.ambiguous(0), 0b0011);
+  EXPECT_EQ(ghosts.ambiguous(1), 0b0111);
+  EXPECT_EQ(ghosts.ambiguous(2), 0b0110);
+}
+
+TEST(GhostFilter, AmbiguousKeysKeepTheirState) {
+  const uint8_t matrix[4] = {0b0111, 0, 0b0101, 0};
+  Filter ghosts           = detect(matrix);
+  // Row 0 had its first and last key pressed before, row 2 only the first.
+  EXPECT_EQ(ghosts.filter(0, matrix[0], 0b0101), 0b0111);
+  EXPECT_EQ(ghosts.filter(2, matrix[2], 0b0001), 0b0001);
+  EXPECT_EQ(ghosts.filter(1, matrix[1], 0b1000), 0);
+}
+
+// -----------------------------------------------------------------------------
+// The virtual key scanner, with the keys in the top left corner of the
+// keymap:
+//
+//   A B E
+//   C D F
+//   G H
+
+bool isReported(Key key) {
+  return Runtime.hid().keyboard().isKeyPressed(key);
+}
+
+class Ghosting : public VirtualDeviceTest {};
+
+TEST_F(Ghosting, KeysOnTheirOwnAreReported) {
+  Runtime.device().keyScanner().setGhostDetection(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  RunCycle();
+  EXPECT_TRUE(isReported(Key_A));
+  EXPECT_TRUE(isReported(Key_B));
+  EXPECT_TRUE(isReported(Key_C));
+  EXPECT_EQ(Runtime.device().keyScanner().pressedKeyswitchCount(), 3);
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  RunCycle();
+  Runtime.device().keyScanner().setGhostDetection(false);
+}
+
+TEST_F(Ghosting, FourthCornerIsHeldBack) {
+  Runtime.device().keyScanner().setGhostDetection(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  RunCycle();
+
+  // On a matrix without diodes, this is what the scan shows now, whether or
+  // not D is actually pressed.
+  sim_.Press(1, 1);  // D
+  auto state = RunCycle();
+  EXPECT_EQ(state->HIDReports()->Keyboard().size(), 0);
+  EXPECT_FALSE(isReported(Key_D));
+  EXPECT_FALSE(Runtime.device().keyScanner().isKeyswitchPressed(KeyAddr(1, 1)));
+  EXPECT_TRUE(isReported(Key_A));
+  EXPECT_TRUE(isReported(Key_B));
+  EXPECT_TRUE(isReported(Key_C));
+
+  // Keys outside the rectangle still work.
+  sim_.Press(2, 0);  // G
+  RunCycle();
+  EXPECT_TRUE(isReported(Key_G));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  sim_.Release(1, 1);  // D
+  sim_.Release(2, 0);  // G
+  RunCycle();
+  Runtime.device().keyScanner().setGhostDetection(false);
+}
+
+TEST_F(Ghosting, RectangleInOneScanIsHeldBack) {
+  Runtime.device().keyScanner().setGhostDetection(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  sim_.Press(1, 1);  // D
+  sim_.Press(0, 2);  // E
+  auto state = RunCycle();
+
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_E.getKeyCode()));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  sim_.Release(1, 1);  // D
+  sim_.Release(0, 2);  // E
+  RunCycle();
+  Runtime.device().keyScanner().setGhostDetection(false);
+}
+
+TEST_F(Ghosting, BrokenRectangleIsAcceptedAgain) {
+  Runtime.device().keyScanner().setGhostDetection(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  sim_.Press(1, 1);  // D
+  RunCycle();
+  EXPECT_FALSE(isReported(Key_A));
+
+  sim_.Release(1, 1);  // D
+  RunCycle();
+  EXPECT_TRUE(isReported(Key_A));
+  EXPECT_TRUE(isReported(Key_B));
+  EXPECT_TRUE(isReported(Key_C));
+  EXPECT_FALSE(isReported(Key_D));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  sim_.Release(1, 1);  // D
+  RunCycle();
+  Runtime.device().keyScanner().setGhostDetection(false);
+}
+
+TEST_F(Ghosting, HeldKeysStayPressedInsideARectangle) {
+  Runtime.device().keyScanner().setGhostDetection(true);
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  RunCycle();
+  sim_.Press(1, 1);  // D
+  RunCycle();
+
+  // Whether A was released can't be told while the others make it look held.
+  sim_.Release(0, 0);  // A
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 2);  // E
+  sim_.Press(1, 2);  // F
+  RunCycle();
+  EXPECT_TRUE(isReported(Key_A));
+  EXPECT_FALSE(isReported(Key_D));
+  EXPECT_FALSE(isReported(Key_E));
+  EXPECT_FALSE(isReported(Key_F));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  sim_.Release(1, 1);  // D
+  sim_.Release(0, 2);  // E
+  sim_.Release(1, 2);  // F
+  RunCycle();
+  Runtime.device().keyScanner().setGhostDetection(false);
+}
+
+TEST_F(Ghosting, DisabledReportsEverything) {
+  sim_.Press(0, 0);  // A
+  sim_.Press(0, 1);  // B
+  sim_.Press(1, 0);  // C
+  sim_.Press(1, 1);  // D
+  RunCycle();
+  EXPECT_TRUE(isReported(Key_A));
+  EXPECT_TRUE(isReported(Key_D));
+
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(1, 0);  // C
+  sim_.Release(1, 1);  // D
+  RunCycle();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,97 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// -----------------------------------------------------------------------------
+// Idling while no key is pressed, with a 50ms timeout.
+
+class IdleWake : public VirtualDeviceTest {};
+
+TEST_F(IdleWake, GoesIdleOnceTheMatrixIsQuiet) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.setIdleTimeout(50);
+  sim_.RunForMillis(10);
+  EXPECT_FALSE(scanner.isIdle());
+
+  sim_.RunForMillis(100);
+  EXPECT_TRUE(scanner.isIdle());
+  EXPECT_FALSE(scanner.scanPending());
+  scanner.setIdleTimeout(0);
+}
+
+TEST_F(IdleWake, HeldKeysKeepTheScannerAwake) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.setIdleTimeout(50);
+  sim_.Press(0, 0);  // A
+  sim_.RunForMillis(200);
+  EXPECT_FALSE(scanner.isIdle());
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  RunCycle();
+  scanner.setIdleTimeout(0);
+}
+
+TEST_F(IdleWake, KeypressWakesTheScannerInTheSameCycle) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.setIdleTimeout(50);
+  sim_.RunForMillis(100);
+  ASSERT_TRUE(scanner.isIdle());
+
+  sim_.Press(0, 0);  // A
+  EXPECT_TRUE(scanner.scanPending());
+  RunCycle();
+  EXPECT_FALSE(scanner.isIdle());
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  RunCycle();
+  EXPECT_FALSE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+  scanner.setIdleTimeout(0);
+}
+
+TEST_F(IdleWake, IdlesAgainAfterRelease) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.setIdleTimeout(50);
+  sim_.RunForMillis(100);
+  sim_.Press(0, 0);  // A
+  sim_.RunForMillis(20);
+  sim_.Release(0, 0);  // A
+
+  sim_.RunForMillis(10);
+  EXPECT_FALSE(scanner.isIdle());
+  sim_.RunForMillis(100);
+  EXPECT_TRUE(scanner.isIdle());
+  scanner.setIdleTimeout(0);
+}
+
+TEST_F(IdleWake, ZeroTimeoutNeverIdles) {
+  auto &scanner = Runtime.device().keyScanner();
+  scanner.setIdleTimeout(0);
+  sim_.RunForMillis(500);
+  EXPECT_FALSE(scanner.isIdle());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
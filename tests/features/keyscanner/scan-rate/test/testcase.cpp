@@ -0,0 +1,274 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/driver/keyscanner/Debounce.h"
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using device::virt::VirtualKeyScanner;
+using driver::keyscanner::ScanRate;
+using RowState     = VirtualKeyScanner::RowState;
+namespace debounce = driver::keyscanner::debounce;
+
+// -----------------------------------------------------------------------------
+// The scan rate on its own.
+
+ScanRate adaptiveRate() {
+  ScanRate rate;
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(8000);
+  rate.setDecay(10);
+  rate.update(true, 0);
+  return rate;
+}
+
+TEST(ScanRate, FixedWithoutASlowInterval) {
+  ScanRate rate;
+  rate.setFastInterval(1000);
+  rate.setDecay(10);
+  EXPECT_FALSE(rate.isAdaptive());
+  EXPECT_TRUE(rate.update(true, 0));
+  EXPECT_EQ(rate.interval(), 1000);
+  EXPECT_FALSE(rate.update(false, 1000));
+  EXPECT_EQ(rate.interval(), 1000);
+}
+
+TEST(ScanRate, DecaysStepByStep) {
+  ScanRate rate = adaptiveRate();
+  EXPECT_EQ(rate.interval(), 1000);
+  EXPECT_FALSE(rate.update(false, 9));
+  EXPECT_TRUE(rate.update(false, 10));
+  EXPECT_EQ(rate.interval(), 2000);
+  EXPECT_TRUE(rate.update(false, 20));
+  EXPECT_EQ(rate.interval(), 4000);
+  EXPECT_TRUE(rate.update(false, 30));
+  EXPECT_EQ(rate.interval(), 8000);
+  EXPECT_FALSE(rate.update(false, 1000));
+  EXPECT_EQ(rate.interval(), 8000);
+}
+
+TEST(ScanRate, StopsAtTheSlowInterval) {
+  ScanRate rate = adaptiveRate();
+  rate.setSlowInterval(6000);
+  rate.update(false, 30);
+  EXPECT_EQ(rate.interval(), 6000);
+}
+
+TEST(ScanRate, WithoutDecayGoesStraightToSlow) {
+  ScanRate rate = adaptiveRate();
+  rate.setDecay(0);
+  EXPECT_TRUE(rate.update(false, 1));
+  EXPECT_EQ(rate.interval(), 8000);
+}
+
+TEST(ScanRate, ActivityGoesStraightBackToFast) {
+  ScanRate rate = adaptiveRate();
+  rate.update(false, 100);
+  EXPECT_TRUE(rate.update(true, 101));
+  EXPECT_EQ(rate.interval(), 1000);
+  // And the decay starts over from there.
+  EXPECT_FALSE(rate.update(false, 110));
+  EXPECT_TRUE(rate.update(false, 111));
+  EXPECT_EQ(rate.interval(), 2000);
+}
+
+TEST(ScanRate, IntervalsAreClampedToTheMaximum) {
+  ScanRate rate;
+  rate.setMaxInterval(8191);
+  rate.setFastInterval(10000);
+  rate.setSlowInterval(65535);
+  EXPECT_EQ(rate.fastInterval(), 8191);
+  EXPECT_EQ(rate.slowInterval(), 8191);
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(8000);
+  EXPECT_EQ(rate.fastInterval(), 1000);
+  EXPECT_EQ(rate.slowInterval(), 8000);
+}
+
+// -----------------------------------------------------------------------------
+// The virtual key scanner, scanning every millisecond (every cycle) while keys
+// are changing, and slowing down to every 4ms. Each test turns the adaptive
+// rate on, and back off again (with a slow interval of 0) when it is done.
+
+VirtualKeyScanner::Debounced<debounce::Symmetric<RowState>> scan_rate_symmetric;
+
+class AdaptiveScanRate : public VirtualDeviceTest {
+ protected:
+  // Toggles the first three keys in a pseudo-random order, with `min_gap` to
+  // `max_gap` cycles between any two changes, and checks that every change is
+  // reported exactly once, and no later than `max_latency` cycles after it was
+  // made.
+  void Trace(uint8_t min_gap, uint8_t max_gap, uint8_t max_latency) {
+    const KeyAddr key_addrs[] = {KeyAddr(0, 0), KeyAddr(0, 1), KeyAddr(0, 2)};
+    const Key keys[]          = {Key_A, Key_B, Key_C};
+    ScanRate &rate            = *Runtime.device().keyScanner().scanRate();
+
+    uint32_t seed         = 12345;
+    bool pressed[3]       = {false, false, false};
+    uint8_t worst_latency = 0;
+    bool saw_slow         = false;
+    bool saw_fast         = false;
+
+    for (uint16_t n = 0; n < 300; n++) {
+      seed        = seed * 1103515245 + 12345;
+      uint8_t i   = (seed >> 16) % 3;
+      uint8_t gap = min_gap + (seed >> 20) % (max_gap - min_gap + 1);
+
+      saw_slow |= rate.interval() == 4000;
+      saw_fast |= rate.interval() == 1000;
+
+      pressed[i] = !pressed[i];
+      if (pressed[i]) {
+        sim_.Press(key_addrs[i]);
+      } else {
+        sim_.Release(key_addrs[i]);
+      }
+
+      uint8_t latency = 0;
+      uint8_t reports = 0;
+      for (uint8_t cycle = 1; cycle <= gap; cycle++) {
+        auto state = RunCycle();
+        reports += state->HIDReports()->Keyboard().size();
+        if (latency == 0 &&
+            Runtime.hid().keyboard().isKeyPressed(keys[i]) == pressed[i])
+          latency = cycle;
+      }
+
+      ASSERT_NE(latency, 0) << "change " << n << " was missed";
+      ASSERT_LE(latency, max_latency) << "change " << n;
+      ASSERT_EQ(reports, 1) << "change " << n;
+      if (latency > worst_latency)
+        worst_latency = latency;
+    }
+
+    // The trace needs to have gone through both rates for this to mean much.
+    EXPECT_TRUE(saw_slow);
+    EXPECT_TRUE(saw_fast);
+    EXPECT_GT(worst_latency, 1);
+  }
+};
+
+TEST_F(AdaptiveScanRate, SlowsDownWhileQuiet) {
+  ScanRate &rate = *Runtime.device().keyScanner().scanRate();
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(4000);
+  rate.setDecay(10);
+
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  EXPECT_EQ(rate.interval(), 1000);
+
+  sim_.RunForMillis(50);
+  EXPECT_EQ(rate.interval(), 4000);
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  // A change is picked up by the next scan, which goes back to the fast rate.
+  sim_.Release(0, 0);  // A
+  sim_.RunCycles(4);
+  EXPECT_FALSE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+  EXPECT_EQ(rate.interval(), 1000);
+
+  rate.setSlowInterval(0);
+  RunCycle();
+}
+
+TEST_F(AdaptiveScanRate, NoChangeIsMissedAcrossRateChanges) {
+  ScanRate &rate = *Runtime.device().keyScanner().scanRate();
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(4000);
+  rate.setDecay(10);
+
+  // As long as every change lasts at least one slow interval, none of them
+  // can be missed, however the scan rate changes in between.
+  Trace(4, 40, 4);
+
+  rate.setSlowInterval(0);
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(0, 2);  // C
+  RunCycle();
+}
+
+TEST_F(AdaptiveScanRate, NoChangeIsMissedWhileDebouncing) {
+  auto &scanner  = Runtime.device().keyScanner();
+  ScanRate &rate = *scanner.scanRate();
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(4000);
+  rate.setDecay(10);
+  scanner.setDebounceFilter(&scan_rate_symmetric);
+
+  // The first sample comes at up to the slow interval, and the other three
+  // that `Symmetric` needs at the fast one.
+  Trace(4 + 3, 40, 4 + 3);
+
+  rate.setSlowInterval(0);
+  sim_.Release(0, 0);  // A
+  sim_.Release(0, 1);  // B
+  sim_.Release(0, 2);  // C
+  sim_.RunCycles(4);
+  scanner.setDebounceFilter(nullptr);
+}
+
+TEST_F(AdaptiveScanRate, FixedRateScansEveryCycle) {
+  ScanRate &rate = *Runtime.device().keyScanner().scanRate();
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(0);
+  rate.setDecay(10);
+
+  sim_.RunForMillis(50);
+  sim_.Press(0, 0);  // A
+  RunCycle();
+  EXPECT_TRUE(Runtime.hid().keyboard().isKeyPressed(Key_A));
+
+  sim_.Release(0, 0);  // A
+  RunCycle();
+}
+
+TEST_F(AdaptiveScanRate, FocusCommands) {
+  ScanRate &rate = *Runtime.device().keyScanner().scanRate();
+  rate.setFastInterval(1000);
+  rate.setSlowInterval(4000);
+  rate.setDecay(10);
+
+  sim_.RunForMillis(50);
+  std::string response = sim_.SendFocusCommand("hardware.scan_interval");
+  EXPECT_NE(response.find("4000"), std::string::npos) << response;
+
+  response = sim_.SendFocusCommand("hardware.scan_interval.fast");
+  EXPECT_NE(response.find("1000"), std::string::npos) << response;
+
+  sim_.SendFocusCommand("hardware.scan_interval.slow 8000");
+  EXPECT_EQ(rate.slowInterval(), 8000);
+  sim_.SendFocusCommand("hardware.scan_interval.decay 5");
+  EXPECT_EQ(rate.decay(), 5);
+  sim_.SendFocusCommand("hardware.scan_interval.fast 2000");
+  EXPECT_EQ(rate.fastInterval(), 2000);
+
+  rate.setSlowInterval(0);
+  RunCycle();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
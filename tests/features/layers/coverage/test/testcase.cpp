@@ -0,0 +1,160 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr uint8_t test_layer_count = 5;
+
+std::vector<uint8_t> active_layer_stack;
+
+void recordActiveLayer(uint8_t index, uint8_t layer) {
+  active_layer_stack.push_back(layer);
+}
+
+// A keymap in RAM, for testing changes to keymap entries.
+Key ram_keymap[test_layer_count][kaleidoscope_internal::device.numKeys()];
+
+Key getKeyFromRAM(uint8_t layer, KeyAddr key_addr) {
+  return ram_keymap[layer][key_addr.toInt()];
+}
+
+class LayerCoverage : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    Layer.getKey = Layer.getKeyFromPROGMEM;
+    Layer.move(0);
+  }
+
+  // Work out which layer each key should be looked up from the slow way: by
+  // looking up every key on every active layer, from the top of the stack down.
+  void CheckActiveLayers() const {
+    active_layer_stack.clear();
+    Layer.forEachActiveLayer(&recordActiveLayer);
+
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      uint8_t expected = 0;
+      for (auto it = active_layer_stack.rbegin(); it != active_layer_stack.rend(); ++it) {
+        if ((*Layer.getKey)(*it, key_addr) != Key_Transparent) {
+          expected = *it;
+          break;
+        }
+      }
+      ASSERT_EQ(Layer.lookupActiveLayer(key_addr), expected)
+        << "Wrong layer for key " << int(key_addr.toInt());
+      ASSERT_EQ(Layer.lookupOnActiveLayer(key_addr), (*Layer.getKey)(expected, key_addr));
+    }
+  }
+
+  // Apply a pseudo-random sequence of layer changes, checking the active layer
+  // map after every one of them.
+  void ShuffleLayers(uint32_t seed, int steps) {
+    for (int step = 0; step < steps; ++step) {
+      seed          = seed * 1103515245 + 12345;
+      uint8_t layer = (seed >> 16) % test_layer_count;
+      switch ((seed >> 24) % 5) {
+      case 0:
+        Layer.activate(layer);
+        break;
+      case 1:
+        Layer.activate(layer + LAYER_SHIFT_OFFSET);
+        break;
+      case 2:
+        Layer.deactivate(layer);
+        break;
+      case 3:
+        Layer.deactivate(layer + LAYER_SHIFT_OFFSET);
+        break;
+      case 4:
+        if ((seed & 0x0F) == 0)
+          Layer.move(layer);
+        break;
+      }
+      CheckActiveLayers();
+    }
+  }
+};
+
+TEST_F(LayerCoverage, MatchesFullLookup) {
+  ASSERT_EQ(layer_count, test_layer_count);
+  CheckActiveLayers();
+  ShuffleLayers(0x1234567, 2000);
+}
+
+TEST_F(LayerCoverage, KeymapReplaced) {
+  for (uint8_t layer = 0; layer < test_layer_count; ++layer) {
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      ram_keymap[layer][key_addr.toInt()] = Layer.getKeyFromPROGMEM(layer, key_addr);
+    }
+  }
+  // Swap the layers 1 & 3, so that the coverage differs from PROGMEM.
+  for (KeyAddr key_addr : KeyAddr::all()) {
+    std::swap(ram_keymap[1][key_addr.toInt()], ram_keymap[3][key_addr.toInt()]);
+  }
+
+  Layer.activate(1);
+  Layer.activate(3);
+  CheckActiveLayers();
+
+  // Replacing `Layer.getKey` gets noticed on the next layer change.
+  Layer.getKey = getKeyFromRAM;
+  Layer.activate(2);
+  CheckActiveLayers();
+  ShuffleLayers(0x89abcdef, 500);
+}
+
+TEST_F(LayerCoverage, KeymapEntryChanged) {
+  for (uint8_t layer = 0; layer < test_layer_count; ++layer) {
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      ram_keymap[layer][key_addr.toInt()] = Layer.getKeyFromPROGMEM(layer, key_addr);
+    }
+  }
+  Layer.getKey = getKeyFromRAM;
+  Layer.activate(4);
+  Layer.activate(1);
+  CheckActiveLayers();
+
+  // Make an entry on layer 4 opaque, and another on layer 1 transparent.
+  constexpr KeyAddr opaque_addr{2, 2};
+  constexpr KeyAddr transparent_addr{0, 1};
+  ram_keymap[4][opaque_addr.toInt()]      = Key_4;
+  ram_keymap[1][transparent_addr.toInt()] = Key_Transparent;
+  Layer.updateLayerCoverage(4, opaque_addr);
+  Layer.updateLayerCoverage(1, transparent_addr);
+  EXPECT_EQ(Layer.lookupActiveLayer(opaque_addr), 4);
+  EXPECT_EQ(Layer.lookupActiveLayer(transparent_addr), 0);
+  CheckActiveLayers();
+
+  ShuffleLayers(0x5555aaaa, 500);
+
+  // Make every entry on layer 2 opaque at once.
+  for (KeyAddr key_addr : KeyAddr::all()) {
+    ram_keymap[2][key_addr.toInt()] = Key_2;
+  }
+  Layer.updateLayerCoverage();
+  CheckActiveLayers();
+  ShuffleLayers(0x0f0f0f0f, 500);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,79 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-Ranges.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_LeftShift, Key_LeftControl, XXX, XXX,
+        ShiftToLayer(1),
+
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F,
+        Key_A, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G,
+        XXX, XXX, XXX, XXX,
+        ShiftToLayer(2)
+    ),
+    [1] = KEYMAP_STACKED
+    (
+        ___,   Key_1, ___,   ___, Key_1, ___, ___,
+        Key_1, ___,   Key_1, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, Key_1, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        Key(kaleidoscope::ranges::TURBO)
+    ),
+    [2] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        kaleidoscope::modLayerKey(Key_RightAlt, 1)
+    ),
+)
+// *INDENT-ON*
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
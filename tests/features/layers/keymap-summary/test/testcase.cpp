@@ -0,0 +1,59 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-Ranges.h>
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class KeymapSummary : public VirtualDeviceTest {};
+
+TEST_F(KeymapSummary, CoverageMatchesKeymap) {
+  ASSERT_EQ(layer_count, 3);
+
+  for (uint8_t layer = 0; layer < layer_count; ++layer) {
+    const uint8_t *coverage = sketch_exploration::progmemLayerCoverage(layer);
+    ASSERT_NE(coverage, nullptr);
+    for (KeyAddr key_addr : KeyAddr::all()) {
+      bool covered = coverage[KeyAddrBitfield::blockIndex(key_addr)] &
+                     (1 << KeyAddrBitfield::bitIndex(key_addr));
+      EXPECT_EQ(covered, Layer.getKeyFromPROGMEM(layer, key_addr) != Key_Transparent)
+        << "Wrong coverage for key " << int(key_addr.toInt()) << " on layer " << int(layer);
+    }
+  }
+  EXPECT_EQ(sketch_exploration::progmemLayerCoverage(layer_count), nullptr);
+}
+
+TEST_F(KeymapSummary, LayerShifts) {
+  // Layer 1 covers only a few keys, which are now looked up from it.
+  sim_.Press(3, 6);  // ShiftToLayer(1)
+  RunCycle();
+  EXPECT_EQ(Layer.lookupOnActiveLayer(KeyAddr{0, 1}), Key_1);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(KeyAddr{0, 0}), Key_A);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(KeyAddr{3, 9}), Key(ranges::TURBO));
+  sim_.Release(3, 6);
+  RunCycle();
+  EXPECT_EQ(Layer.lookupOnActiveLayer(KeyAddr{0, 1}), Key_B);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
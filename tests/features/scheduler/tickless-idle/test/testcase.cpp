@@ -0,0 +1,112 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>  // for vector
+
+#include "kaleidoscope/Scheduler.h"
+#include "testing/setup-googletest.h"
+
+extern std::vector<uint32_t> timeouts;
+extern kaleidoscope::Timer timeout_timer;
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class TicklessIdle : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    timeout_timer.cancel();
+    Runtime.setMaxIdleTime(0);
+    RunCycle();
+    timeouts.clear();
+  }
+
+  void TearDown() override {
+    Runtime.setMaxIdleTime(0);
+  }
+
+  // The time between the start of this cycle and the next one.
+  uint32_t NextCycleInterval() {
+    uint32_t start_time = Runtime.millisAtCycleStart();
+    RunCycle();
+    return Runtime.millisAtCycleStart() - start_time;
+  }
+};
+
+TEST_F(TicklessIdle, DisabledByDefault) {
+  EXPECT_EQ(Runtime.maxIdleTime(), 0);
+  RunCycle();
+  EXPECT_LE(NextCycleInterval(), 2);
+}
+
+TEST_F(TicklessIdle, SleepsUpToTheLimit) {
+  Runtime.setMaxIdleTime(20);
+  RunCycle();
+  uint32_t interval = NextCycleInterval();
+  EXPECT_GE(interval, 20);
+  EXPECT_LE(interval, 22);
+}
+
+TEST_F(TicklessIdle, WakesForTheNextDeadline) {
+  Runtime.setMaxIdleTime(1000);
+  uint32_t start_time = Runtime.millisAtCycleStart();
+  timeout_timer.start(50);
+
+  RunCycle();
+  EXPECT_TRUE(timeouts.empty());
+  RunCycle();
+
+  ASSERT_EQ(timeouts.size(), 1);
+  EXPECT_GE(timeouts[0] - start_time, 50);
+  EXPECT_LE(timeouts[0] - start_time, 52);
+}
+
+TEST_F(TicklessIdle, NoSleepWhileKeysAreHeld) {
+  Runtime.setMaxIdleTime(20);
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  EXPECT_LE(NextCycleInterval(), 2);
+
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+  EXPECT_GE(NextCycleInterval(), 20);
+}
+
+TEST_F(TicklessIdle, WakesForTheOneShotTimeout) {
+  // The sketch sets the OneShot timeout to 100ms.
+  Runtime.setMaxIdleTime(1000);
+  sim_.Press(KeyAddr{0, 1});  // OSM(LeftShift)
+  RunCycle();
+  uint32_t start_time = Runtime.millisAtCycleStart();
+  sim_.Release(KeyAddr{0, 1});  // OSM(LeftShift)
+  RunCycle();
+
+  // OneShot polls for its timeout, without a `Timer`, so it's the only one
+  // that can keep the keyboard from sleeping past it.
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_TRUE(state->HIDReports()->Keyboard(0).ActiveKeycodes().empty());
+  EXPECT_GE(Runtime.millisAtCycleStart() - start_time, 100);
+  EXPECT_LE(Runtime.millisAtCycleStart() - start_time, 102);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,156 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "kaleidoscope/Scheduler.h"
+#include "testing/setup-googletest.h"
+
+struct TimerCall {
+  std::string name;
+  uint32_t cycle_start;
+};
+extern std::vector<TimerCall> timer_calls;
+extern std::vector<uint32_t> cycle_starts;
+extern int32_t restart_a_with;
+extern kaleidoscope::Timer timer_a;
+extern kaleidoscope::Timer timer_b;
+extern kaleidoscope::Timer timer_c;
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class SchedulerTimers : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    timer_a.cancel();
+    timer_b.cancel();
+    timer_c.cancel();
+    restart_a_with = -1;
+    RunCycle();
+    timer_calls.clear();
+    cycle_starts.clear();
+  }
+
+  std::vector<std::string> CallNames() {
+    std::vector<std::string> names;
+    for (const TimerCall &call : timer_calls)
+      names.push_back(call.name);
+    return names;
+  }
+
+  // The start time of the first cycle in which `hasTimeExpired()` would have
+  // reported the timeout.
+  uint32_t FirstExpiredCycle(uint16_t start_time, uint16_t ttl) {
+    for (uint32_t cycle_start : cycle_starts) {
+      if (uint16_t(uint16_t(cycle_start) - start_time) >= ttl)
+        return cycle_start;
+    }
+    return 0;
+  }
+};
+
+TEST_F(SchedulerTimers, FiresInTheCycleTheTimeoutExpires) {
+  uint16_t start_time = Runtime.millisAtCycleStart();
+  timer_a.start(10);
+  EXPECT_TRUE(timer_a.isActive());
+
+  sim_.RunForMillis(20);
+
+  ASSERT_EQ(timer_calls.size(), 1);
+  EXPECT_EQ(timer_calls[0].cycle_start, FirstExpiredCycle(start_time, 10));
+  EXPECT_FALSE(timer_a.isActive());
+  EXPECT_FALSE(Scheduler::hasActiveTimers());
+}
+
+TEST_F(SchedulerTimers, StartAtUsesTheGivenStartTime) {
+  uint16_t start_time = Runtime.millisAtCycleStart() - 4;
+  timer_a.startAt(start_time, uint16_t(10));
+
+  sim_.RunForMillis(20);
+
+  ASSERT_EQ(timer_calls.size(), 1);
+  EXPECT_EQ(timer_calls[0].cycle_start, FirstExpiredCycle(start_time, 10));
+}
+
+TEST_F(SchedulerTimers, CancelledTimersDoNotFire) {
+  timer_a.start(5);
+  timer_b.start(10);
+  timer_a.cancel();
+  EXPECT_FALSE(timer_a.isActive());
+  EXPECT_TRUE(timer_b.isActive());
+
+  sim_.RunForMillis(20);
+
+  EXPECT_EQ(CallNames(), (std::vector<std::string>{"b"}));
+}
+
+TEST_F(SchedulerTimers, RestartingMovesTheDeadline) {
+  uint16_t start_time = Runtime.millisAtCycleStart();
+  timer_a.start(5);
+  timer_a.start(15);
+
+  sim_.RunForMillis(30);
+
+  ASSERT_EQ(timer_calls.size(), 1);
+  EXPECT_EQ(timer_calls[0].cycle_start, FirstExpiredCycle(start_time, 15));
+}
+
+TEST_F(SchedulerTimers, FiresInDeadlineOrder) {
+  timer_a.start(8);
+  timer_b.start(8);
+  timer_c.start(3);
+
+  sim_.RunForMillis(20);
+
+  EXPECT_EQ(CallNames(), (std::vector<std::string>{"c", "a", "b"}));
+}
+
+TEST_F(SchedulerTimers, ReportsTheNextDeadline) {
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), Scheduler::no_deadline);
+
+  timer_a.start(40);
+  timer_b.start(25);
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), 25);
+
+  uint32_t start_time = Runtime.millisAtCycleStart();
+  RunCycle();
+  uint32_t elapsed = Runtime.millisAtCycleStart() - start_time;
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), 25 - elapsed);
+
+  timer_b.cancel();
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), 40 - elapsed);
+}
+
+TEST_F(SchedulerTimers, TimersRestartedByCallbacksWaitForTheNextCycle) {
+  restart_a_with = 0;
+  timer_a.start(5);
+
+  sim_.RunForMillis(20);
+
+  ASSERT_EQ(timer_calls.size(), 2);
+  EXPECT_GT(timer_calls[1].cycle_start, timer_calls[0].cycle_start);
+  EXPECT_FALSE(timer_a.isActive());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,101 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+
+#include <string>
+#include <vector>
+
+#include "kaleidoscope/Scheduler.h"
+
+// A record of every timer callback, and the cycle it was called in.
+struct TimerCall {
+  std::string name;
+  uint32_t cycle_start;
+};
+std::vector<TimerCall> timer_calls;
+
+// The start time of every cycle, as seen by `afterEachCycle()`.
+std::vector<uint32_t> cycle_starts;
+
+// When set, `timer_a`'s callback restarts it with this timeout (once).
+int32_t restart_a_with = -1;
+
+void logTimer(void *context) {
+  timer_calls.push_back({static_cast<const char *>(context),
+                         kaleidoscope::Runtime.millisAtCycleStart()});
+}
+
+extern kaleidoscope::Timer timer_a;
+
+void runTimerA(void *context) {
+  logTimer(context);
+  if (restart_a_with >= 0) {
+    timer_a.start(restart_a_with);
+    restart_a_with = -1;
+  }
+}
+
+kaleidoscope::Timer timer_a{&runTimerA, const_cast<char *>("a")};
+kaleidoscope::Timer timer_b{&logTimer, const_cast<char *>("b")};
+kaleidoscope::Timer timer_c{&logTimer, const_cast<char *>("c")};
+
+namespace kaleidoscope {
+namespace plugin {
+
+class CycleLog : public Plugin {
+ public:
+  EventHandlerResult afterEachCycle() {
+    cycle_starts.push_back(Runtime.millisAtCycleStart());
+    return EventHandlerResult::OK;
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::CycleLog CycleLog;
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(CycleLog);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
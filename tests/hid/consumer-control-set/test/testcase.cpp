@@ -0,0 +1,205 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <KeyboardioHID.h>  // for ConsumerControl
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr uint16_t VolumeUp   = HID_CONSUMER_VOLUME_INCREMENT;
+constexpr uint16_t VolumeDown = HID_CONSUMER_VOLUME_DECREMENT;
+constexpr uint16_t PlayPause  = HID_CONSUMER_PLAY_SLASH_PAUSE;
+constexpr uint16_t Search     = HID_CONSUMER_AC_SEARCH;
+constexpr uint16_t Mute       = HID_CONSUMER_MUTE;
+
+// -----------------------------------------------------------------------------
+// The set of pressed usages, driven directly.
+
+class UsageSet : public VirtualDeviceTest {
+ protected:
+  std::unique_ptr<State> Send(size_t expected_reports) {
+    ConsumerControl.sendReport();
+    auto state = State::Snapshot();
+    EXPECT_EQ(state->HIDReports()->ConsumerControl().size(), expected_reports);
+    return state;
+  }
+};
+
+TEST_F(UsageSet, PressOrderDoesNotMatter) {
+  ConsumerControl.press(Search);
+  ConsumerControl.press(VolumeUp);
+  auto state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(VolumeUp, Search));
+
+  ConsumerControl.releaseAll();
+  ConsumerControl.press(VolumeUp);
+  ConsumerControl.press(Search);
+  Send(0);
+
+  ConsumerControl.releaseAll();
+  ConsumerControl.sendReport();
+  State::Snapshot();
+}
+
+TEST_F(UsageSet, PressingTwiceIsPressingOnce) {
+  ConsumerControl.press(Mute);
+  ConsumerControl.press(Mute);
+  ConsumerControl.press(Search);
+  ConsumerControl.press(Search);
+  auto state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(Mute, Search));
+
+  ConsumerControl.release(Mute);
+  ConsumerControl.release(Search);
+  state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(), IsEmpty());
+
+  ConsumerControl.releaseAll();
+  ConsumerControl.sendReport();
+  State::Snapshot();
+}
+
+TEST_F(UsageSet, UsagesThatDoNotFitWaitForRoom) {
+  ConsumerControl.press(Search);
+  ConsumerControl.press(VolumeUp);
+  ConsumerControl.press(VolumeDown);
+  ConsumerControl.press(Mute);
+  ConsumerControl.press(PlayPause);
+  auto state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(VolumeUp, VolumeDown, Mute, PlayPause));
+
+  ConsumerControl.release(VolumeDown);
+  state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(VolumeUp, Mute, PlayPause, Search));
+
+  ConsumerControl.releaseAll();
+  ConsumerControl.sendReport();
+  State::Snapshot();
+}
+
+TEST_F(UsageSet, FifthUncommonUsageIsIgnored) {
+  ConsumerControl.press(HID_CONSUMER_AC_BACK);
+  ConsumerControl.press(HID_CONSUMER_AC_FORWARD);
+  ConsumerControl.press(HID_CONSUMER_AC_STOP);
+  ConsumerControl.press(HID_CONSUMER_AC_REFRESH);
+  ConsumerControl.press(Search);
+  auto state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(HID_CONSUMER_AC_BACK, HID_CONSUMER_AC_FORWARD,
+                          HID_CONSUMER_AC_STOP, HID_CONSUMER_AC_REFRESH));
+
+  // There's no room left to keep it in, so it isn't sent later either.
+  ConsumerControl.release(HID_CONSUMER_AC_BACK);
+  state = Send(1);
+  EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+              ElementsAre(HID_CONSUMER_AC_FORWARD, HID_CONSUMER_AC_STOP,
+                          HID_CONSUMER_AC_REFRESH));
+
+  ConsumerControl.releaseAll();
+  ConsumerControl.sendReport();
+  State::Snapshot();
+}
+
+// -----------------------------------------------------------------------------
+// Consumer keys through the whole event pipeline.
+
+class ConsumerReports : public VirtualDeviceTest {
+ protected:
+  // Turns the encoder by `detents`, which press and release a volume key in
+  // back to back cycles, and checks that each press and each release takes
+  // exactly one consumer report, and no keyboard report.
+  void Spin(KeyAddr key_addr, uint16_t usage, uint8_t detents, uint16_t held = 0) {
+    for (uint8_t detent = 0; detent < detents; detent++) {
+      sim_.Press(key_addr);
+      auto state = RunCycle();
+      ASSERT_EQ(state->HIDReports()->ConsumerControl().size(), 1) << "detent " << int(detent);
+      EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+                  ::testing::Contains(usage));
+      EXPECT_EQ(state->HIDReports()->Keyboard().size(), 0);
+
+      sim_.Release(key_addr);
+      state = RunCycle();
+      ASSERT_EQ(state->HIDReports()->ConsumerControl().size(), 1) << "detent " << int(detent);
+      EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+                  ::testing::Not(::testing::Contains(usage)));
+      EXPECT_EQ(state->HIDReports()->Keyboard().size(), 0);
+      if (held != 0) {
+        EXPECT_THAT(state->HIDReports()->ConsumerControl(0).ActiveKeycodes(),
+                    ElementsAre(held));
+      }
+    }
+  }
+};
+
+TEST_F(ConsumerReports, RapidVolumeChanges) {
+  Spin(KeyAddr(0, 1), VolumeUp, 40);
+  Spin(KeyAddr(0, 2), VolumeDown, 40);
+  for (uint8_t turn = 0; turn < 10; turn++) {
+    Spin(KeyAddr(0, 1), VolumeUp, 1);
+    Spin(KeyAddr(0, 2), VolumeDown, 1);
+  }
+  EXPECT_EQ(RunCycle()->HIDReports()->ConsumerControl().size(), 0);
+}
+
+TEST_F(ConsumerReports, RapidVolumeChangesWhileMuteIsHeld) {
+  sim_.Press(0, 5);  // Mute
+  ASSERT_EQ(RunCycle()->HIDReports()->ConsumerControl().size(), 1);
+  Spin(KeyAddr(0, 1), VolumeUp, 40, Mute);
+  Spin(KeyAddr(0, 2), VolumeDown, 40, Mute);
+
+  sim_.Release(0, 5);  // Mute
+  RunCycle();
+}
+
+TEST_F(ConsumerReports, TypingDoesNotResendHeldUsages) {
+  // Mute comes after the volume key in the keymap, but is pressed first, so the
+  // report is rebuilt in a different order on every key event.
+  sim_.Press(0, 5);  // Mute
+  RunCycle();
+  sim_.Press(0, 1);  // Volume up
+  RunCycle();
+
+  for (uint8_t tap = 0; tap < 5; tap++) {
+    sim_.Press(0, 0);  // A
+    auto state = RunCycle();
+    EXPECT_EQ(state->HIDReports()->Keyboard().size(), 1);
+    EXPECT_EQ(state->HIDReports()->ConsumerControl().size(), 0);
+    sim_.Release(0, 0);  // A
+    state = RunCycle();
+    EXPECT_EQ(state->HIDReports()->Keyboard().size(), 1);
+    EXPECT_EQ(state->HIDReports()->ConsumerControl().size(), 0);
+  }
+
+  sim_.Release(0, 5);  // Mute
+  sim_.Release(0, 1);  // Volume up
+  RunCycle();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,233 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <KeyboardioHID.h>  // for BootKeyboard
+
+#include <algorithm>  // for sort
+#include <vector>     // for vector
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+constexpr KeyAddr key_addr_A{0, 0};
+constexpr KeyAddr key_addr_B{0, 1};
+constexpr KeyAddr key_addr_Shift{0, 2};
+constexpr KeyAddr key_addr_Shift1{0, 3};
+constexpr KeyAddr key_addr_Shift2{0, 4};
+constexpr KeyAddr key_addr_1{0, 5};
+
+constexpr uint8_t A     = HID_KEYBOARD_A_AND_A;
+constexpr uint8_t B     = HID_KEYBOARD_B_AND_B;
+constexpr uint8_t One   = HID_KEYBOARD_1_AND_EXCLAMATION_POINT;
+constexpr uint8_t Shift = HID_KEYBOARD_LEFT_SHIFT;
+
+// -----------------------------------------------------------------------------
+// The report sequence of `BootKeyboardAPI::sendReport()`, driven directly.
+
+class ReportSequence : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    State::Snapshot();
+  }
+
+  void TearDown() override {
+    BootKeyboard().releaseAll();
+    BootKeyboard().sendReport();
+    State::Snapshot();
+  }
+
+  // Sends the changes made to the report, and checks that the return value
+  // matches the number of reports the host got.
+  std::unique_ptr<State> Send(size_t expected_reports) {
+    int reports_sent = BootKeyboard().sendReport();
+    auto state       = State::Snapshot();
+    EXPECT_EQ(reports_sent, expected_reports);
+    EXPECT_EQ(state->HIDReports()->Keyboard().size(), expected_reports);
+    return state;
+  }
+};
+
+TEST_F(ReportSequence, NoChangeSendsNothing) {
+  Send(0);
+  BootKeyboard().press(A);
+  Send(1);
+  Send(0);
+}
+
+TEST_F(ReportSequence, KeyChangesGoInOneReport) {
+  BootKeyboard().press(A);
+  Send(1);
+  BootKeyboard().release(A);
+  BootKeyboard().press(B);
+  auto state = Send(1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              UnorderedElementsAre(B));
+}
+
+TEST_F(ReportSequence, ModifierChangesGoInOneReport) {
+  BootKeyboard().press(A);
+  Send(1);
+  BootKeyboard().press(Shift);
+  Send(1);
+  BootKeyboard().release(Shift);
+  Send(1);
+}
+
+TEST_F(ReportSequence, ModifierGoesBeforeNewKey) {
+  BootKeyboard().press(Shift);
+  BootKeyboard().press(One);
+  auto state = Send(2);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              UnorderedElementsAre(Shift));
+  EXPECT_THAT(state->HIDReports()->Keyboard(1).ActiveKeycodes(),
+              UnorderedElementsAre(Shift, One));
+}
+
+TEST_F(ReportSequence, ReleasedKeyGoesBeforeModifier) {
+  BootKeyboard().press(Shift);
+  BootKeyboard().press(One);
+  Send(2);
+  BootKeyboard().release(Shift);
+  BootKeyboard().release(One);
+  auto state = Send(2);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              UnorderedElementsAre(Shift));
+  EXPECT_THAT(state->HIDReports()->Keyboard(1).ActiveKeycodes(), IsEmpty());
+}
+
+TEST_F(ReportSequence, AllThreeOnlyWhenNeeded) {
+  BootKeyboard().press(A);
+  Send(1);
+  BootKeyboard().release(A);
+  BootKeyboard().press(Shift);
+  BootKeyboard().press(B);
+  auto state = Send(3);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(), IsEmpty());
+  EXPECT_THAT(state->HIDReports()->Keyboard(1).ActiveKeycodes(),
+              UnorderedElementsAre(Shift));
+  EXPECT_THAT(state->HIDReports()->Keyboard(2).ActiveKeycodes(),
+              UnorderedElementsAre(Shift, B));
+}
+
+// -----------------------------------------------------------------------------
+// Keystrokes through the whole event pipeline, with the keys in the top left
+// corner of the keymap:
+//
+//   A B LeftShift LSHIFT(1) LSHIFT(2) 1
+
+class KeystrokeReports : public VirtualDeviceTest {
+ protected:
+  void TearDown() override {
+    for (KeyAddr key_addr : {key_addr_A, key_addr_B, key_addr_Shift,
+                             key_addr_Shift1, key_addr_Shift2, key_addr_1})
+      sim_.Release(key_addr);
+    RunCycle();
+  }
+
+  size_t Press(KeyAddr key_addr) {
+    sim_.Press(key_addr);
+    return RunCycle()->HIDReports()->Keyboard().size();
+  }
+  size_t Release(KeyAddr key_addr) {
+    sim_.Release(key_addr);
+    return RunCycle()->HIDReports()->Keyboard().size();
+  }
+};
+
+TEST_F(KeystrokeReports, PlainKeysTakeOneReport) {
+  EXPECT_EQ(Press(key_addr_A), 1);
+  EXPECT_EQ(Release(key_addr_A), 1);
+}
+
+TEST_F(KeystrokeReports, RolloverTakesOneReport) {
+  EXPECT_EQ(Press(key_addr_A), 1);
+  EXPECT_EQ(Press(key_addr_B), 1);
+  EXPECT_EQ(Release(key_addr_A), 1);
+  EXPECT_EQ(Release(key_addr_B), 1);
+}
+
+TEST_F(KeystrokeReports, ModifierRolloverTakesOneReport) {
+  EXPECT_EQ(Press(key_addr_Shift), 1);
+  EXPECT_EQ(Press(key_addr_A), 1);
+  EXPECT_EQ(Release(key_addr_Shift), 1);
+  EXPECT_EQ(Press(key_addr_Shift), 1);
+  EXPECT_EQ(Release(key_addr_A), 1);
+  EXPECT_EQ(Release(key_addr_Shift), 1);
+}
+
+TEST_F(KeystrokeReports, ModifiedKeysNeedTheirModifierFirst) {
+  EXPECT_EQ(Press(key_addr_Shift1), 2);
+  EXPECT_EQ(Release(key_addr_Shift1), 2);
+}
+
+TEST_F(KeystrokeReports, RolloverOutOfAModifiedKey) {
+  EXPECT_EQ(Press(key_addr_Shift1), 2);
+  // The shift of the held key doesn't apply to the next one, and has to be
+  // gone before it's pressed.
+  sim_.Press(key_addr_B);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 2);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              UnorderedElementsAre(One));
+  EXPECT_THAT(state->HIDReports()->Keyboard(1).ActiveKeycodes(),
+              UnorderedElementsAre(One, B));
+}
+
+TEST_F(KeystrokeReports, RolloverBetweenModifiedKeys) {
+  EXPECT_EQ(Press(key_addr_Shift1), 2);
+  sim_.Press(key_addr_Shift2);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              UnorderedElementsAre(Shift, One, HID_KEYBOARD_2_AND_AT));
+}
+
+TEST_F(KeystrokeReports, MedianKeystrokeTakesOneReport) {
+  // Some typing, with rollover, capitals, and a symbol.
+  const struct {
+    KeyAddr key_addr;
+    bool press;
+  } events[] = {
+    {key_addr_A, true}, {key_addr_B, true}, {key_addr_A, false},
+    {key_addr_B, false}, {key_addr_Shift, true}, {key_addr_A, true},
+    {key_addr_Shift, false}, {key_addr_A, false}, {key_addr_1, true},
+    {key_addr_B, true}, {key_addr_1, false}, {key_addr_Shift1, true},
+    {key_addr_B, false}, {key_addr_Shift1, false}, {key_addr_A, true},
+    {key_addr_A, false},
+  };
+
+  std::vector<size_t> counts;
+  for (auto event : events)
+    counts.push_back(event.press ? Press(event.key_addr) : Release(event.key_addr));
+
+  for (size_t count : counts)
+    EXPECT_GE(count, 1);
+  std::sort(counts.begin(), counts.end());
+  EXPECT_EQ(counts[counts.size() / 2], 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
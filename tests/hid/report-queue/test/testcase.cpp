@@ -0,0 +1,392 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "kaleidoscope/driver/hid/PrioritizedReportQueue.h"
+#include "kaleidoscope/driver/hid/ReportQueue.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::hid::Coalesce;
+using driver::hid::ReportKind;
+using ::testing::ElementsAre;
+
+constexpr uint8_t keyboard_id = 0;
+constexpr uint8_t mouse_id    = 2;
+
+// An endpoint that takes one report per USB frame while the host is polling,
+// and none while it isn't.
+class FakeEndpoint {
+ public:
+  struct Report {
+    uint8_t report_id;
+    std::vector<uint8_t> data;
+  };
+
+  bool polling = true;
+  std::vector<Report> sent;
+
+  bool ready() {
+    return polling && !busy_;
+  }
+  bool sendReport(uint8_t report_id, const void *data, uint8_t len) {
+    if (!ready())
+      return false;
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    sent.push_back({report_id, std::vector<uint8_t>(bytes, bytes + len)});
+    busy_ = true;
+    return true;
+  }
+  void nextFrame() {
+    busy_ = false;
+  }
+
+ private:
+  bool busy_ = false;
+};
+
+typedef driver::hid::ReportQueue<4, 5> Queue;
+
+class ReportQueue : public ::testing::Test {
+ protected:
+  Queue queue_;
+  FakeEndpoint endpoint_;
+
+  void pushKeys(uint8_t keys) {
+    queue_.push(keyboard_id, &keys, 1, Coalesce::State);
+  }
+  void pushMouse(uint8_t buttons, int8_t x, int8_t y) {
+    const uint8_t report[5] = {buttons, uint8_t(x), uint8_t(y), 0, 0};
+    queue_.push(mouse_id, report, sizeof(report), Coalesce::MouseDeltas);
+  }
+
+  // Lets the host poll until the queue is empty.
+  void drain() {
+    for (uint8_t frame = 0; frame < 100 && !queue_.empty(); frame++) {
+      endpoint_.nextFrame();
+      queue_.flush(endpoint_);
+    }
+  }
+
+  std::vector<uint8_t> sentKeys() const {
+    std::vector<uint8_t> keys;
+    for (const auto &report : endpoint_.sent)
+      if (report.report_id == keyboard_id)
+        keys.push_back(report.data[0]);
+    return keys;
+  }
+  int sentMovement(uint8_t axis) const {
+    int sum = 0;
+    for (const auto &report : endpoint_.sent)
+      if (report.report_id == mouse_id)
+        sum += int8_t(report.data[axis]);
+    return sum;
+  }
+};
+
+TEST_F(ReportQueue, ReadyEndpointGetsTheReportRightAway) {
+  pushKeys(0b01);
+  EXPECT_EQ(queue_.flush(endpoint_), 1);
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_THAT(sentKeys(), ElementsAre(0b01));
+}
+
+TEST_F(ReportQueue, OneReportPerFrame) {
+  pushKeys(0b01);
+  pushKeys(0b11);
+  EXPECT_EQ(queue_.flush(endpoint_), 1);
+  EXPECT_EQ(queue_.flush(endpoint_), 0);
+  endpoint_.nextFrame();
+  EXPECT_EQ(queue_.flush(endpoint_), 1);
+  EXPECT_THAT(sentKeys(), ElementsAre(0b01, 0b11));
+}
+
+TEST_F(ReportQueue, KeyStatesAreKeptInOrder) {
+  endpoint_.polling = false;
+  // A tap, and a press: every change has to get to the host.
+  pushKeys(0b01);
+  pushKeys(0b00);
+  pushKeys(0b10);
+  EXPECT_EQ(queue_.size(), 3);
+  EXPECT_EQ(queue_.coalescedCount(), 0);
+
+  endpoint_.polling = true;
+  drain();
+  EXPECT_THAT(sentKeys(), ElementsAre(0b01, 0b00, 0b10));
+}
+
+TEST_F(ReportQueue, RepeatedStateIsLeftOut) {
+  endpoint_.polling = false;
+  pushKeys(0b01);
+  pushKeys(0b01);
+  EXPECT_EQ(queue_.size(), 1);
+  EXPECT_EQ(queue_.coalescedCount(), 1);
+}
+
+TEST_F(ReportQueue, FullQueueKeepsTheLatestState) {
+  endpoint_.polling = false;
+  for (uint8_t keys = 1; keys <= 6; keys++)
+    pushKeys(keys);
+  EXPECT_EQ(queue_.size(), 4);
+  EXPECT_EQ(queue_.coalescedCount(), 2);
+  EXPECT_EQ(queue_.droppedCount(), 0);
+
+  endpoint_.polling = true;
+  drain();
+  EXPECT_THAT(sentKeys(), ElementsAre(1, 2, 3, 6));
+}
+
+TEST_F(ReportQueue, MouseMovementIsAddedUp) {
+  endpoint_.polling = false;
+  pushMouse(0, 1, 2);
+  pushMouse(0, 3, -1);
+  pushMouse(0, -2, 5);
+  EXPECT_EQ(queue_.size(), 1);
+  EXPECT_EQ(queue_.coalescedCount(), 2);
+
+  endpoint_.polling = true;
+  drain();
+  ASSERT_EQ(endpoint_.sent.size(), 1);
+  EXPECT_THAT(endpoint_.sent[0].data, ElementsAre(0, 2, 6, 0, 0));
+}
+
+TEST_F(ReportQueue, MouseButtonChangesAreKept) {
+  endpoint_.polling = false;
+  pushMouse(0, 1, 0);
+  pushMouse(1, 0, 0);
+  pushMouse(0, 0, 0);
+  pushMouse(0, 1, 0);
+  EXPECT_EQ(queue_.size(), 3);
+}
+
+TEST_F(ReportQueue, MovementThatDoesNotFitGetsItsOwnReport) {
+  endpoint_.polling = false;
+  pushMouse(0, 100, 0);
+  pushMouse(0, 100, 0);
+  EXPECT_EQ(queue_.size(), 2);
+  EXPECT_EQ(queue_.coalescedCount(), 0);
+}
+
+TEST_F(ReportQueue, FullQueueAddsUpMovementAcrossButtons) {
+  endpoint_.polling = false;
+  pushKeys(0b01);
+  pushKeys(0b00);
+  pushKeys(0b01);
+  pushMouse(0, 10, 0);
+  pushMouse(1, 5, 0);
+  EXPECT_EQ(queue_.size(), 4);
+  EXPECT_EQ(queue_.coalescedCount(), 1);
+
+  endpoint_.polling = true;
+  drain();
+  EXPECT_EQ(sentMovement(1), 15);
+  EXPECT_EQ(endpoint_.sent.back().data[0], 1);
+}
+
+TEST_F(ReportQueue, FullQueueDropsTheOldestWhenNothingCombines) {
+  endpoint_.polling = false;
+  for (uint8_t keys = 1; keys <= 4; keys++)
+    pushKeys(keys);
+  pushMouse(1, 0, 0);
+  EXPECT_EQ(queue_.size(), 4);
+  EXPECT_EQ(queue_.droppedCount(), 1);
+
+  endpoint_.polling = true;
+  drain();
+  EXPECT_THAT(sentKeys(), ElementsAre(2, 3, 4));
+  EXPECT_EQ(endpoint_.sent.back().report_id, mouse_id);
+}
+
+TEST_F(ReportQueue, NoMovementIsLostWhileTheHostIsAway) {
+  // MouseKeys moving the pointer every cycle, and a tap in the middle of it,
+  // while the host has stopped polling.
+  endpoint_.polling = false;
+  for (uint8_t cycle = 0; cycle < 50; cycle++) {
+    pushMouse(0, 5, -3);
+    if (cycle == 20)
+      pushKeys(0b01);
+    if (cycle == 21)
+      pushKeys(0b00);
+    queue_.flush(endpoint_);
+  }
+  EXPECT_LE(queue_.size(), 4);
+  EXPECT_EQ(queue_.droppedCount(), 0);
+
+  endpoint_.polling = true;
+  drain();
+  EXPECT_EQ(sentMovement(1), 250);
+  EXPECT_EQ(sentMovement(2), -150);
+  EXPECT_THAT(sentKeys(), ElementsAre(0b01, 0b00));
+}
+
+TEST_F(ReportQueue, TakeHandsOutTheOldestReport) {
+  pushKeys(0b01);
+  pushMouse(0, 3, 4);
+  uint8_t report_id;
+  uint8_t data[5];
+  EXPECT_EQ(queue_.take(report_id, data), 1);
+  EXPECT_EQ(report_id, keyboard_id);
+  EXPECT_EQ(data[0], 0b01);
+  EXPECT_EQ(queue_.take(report_id, data), 5);
+  EXPECT_EQ(report_id, mouse_id);
+  EXPECT_THAT(data, ElementsAre(0, 3, 4, 0, 0));
+  EXPECT_EQ(queue_.take(report_id, data), 0);
+}
+
+TEST_F(ReportQueue, TakenReportIsNotCombinedWithLaterOnes) {
+  // A driver retrying a report it took must not have movement added to it.
+  pushMouse(0, 3, 4);
+  uint8_t report_id;
+  uint8_t data[5];
+  queue_.take(report_id, data);
+  pushMouse(0, 1, 1);
+  EXPECT_EQ(queue_.size(), 1);
+  EXPECT_EQ(queue_.coalescedCount(), 0);
+  EXPECT_THAT(data, ElementsAre(0, 3, 4, 0, 0));
+}
+
+TEST_F(ReportQueue, StatsAddUp) {
+  endpoint_.polling = false;
+  pushKeys(0b01);
+  pushKeys(0b01);
+  pushMouse(0, 1, 0);
+  pushMouse(0, 1, 0);
+
+  driver::hid::ReportQueue<2, 1> other;
+  const uint8_t keys[] = {1, 2, 3};
+  for (uint8_t key : keys)
+    other.push(keyboard_id, &key, 1, Coalesce::State);
+
+  driver::hid::ReportQueueStats stats = driver::hid::ReportQueueStats();
+  queue_.addStatsTo(stats);
+  other.addStatsTo(stats);
+  EXPECT_EQ(stats.queued, 4);
+  EXPECT_EQ(stats.coalesced, 3);
+  EXPECT_EQ(stats.dropped, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Key reports ahead of mouse movement, as the Bluefruit BLE driver queues them.
+// Boot protocol reports have no report ID, and the driver queues them with IDs
+// of its own, which have to come back out unchanged, or a boot mouse report
+// would be sent as a boot keyboard report.
+
+constexpr uint8_t boot_keyboard_id = 0;
+constexpr uint8_t boot_mouse_id    = 0xff;
+
+typedef driver::hid::PrioritizedReportQueue<8, 4, 5> PrioritizedQueue;
+
+struct Taken {
+  uint8_t report_id;
+  std::vector<uint8_t> data;
+};
+
+std::vector<Taken> takeAll(PrioritizedQueue &queue) {
+  std::vector<Taken> taken;
+  uint8_t report_id;
+  uint8_t data[5];
+  while (uint8_t len = queue.take(report_id, data))
+    taken.push_back({report_id, std::vector<uint8_t>(data, data + len)});
+  return taken;
+}
+
+void pushBootMouse(PrioritizedQueue &queue, uint8_t buttons, int8_t x) {
+  const uint8_t report[3] = {buttons, uint8_t(x), 0};
+  queue.push(boot_mouse_id, report, sizeof(report), ReportKind::RelativeMouse);
+}
+
+TEST(PrioritizedReportQueue, KeyReportsGoFirst) {
+  PrioritizedQueue queue;
+  const uint8_t keys = 0b01;
+  pushBootMouse(queue, 0, 5);
+  queue.push(boot_keyboard_id, &keys, 1, ReportKind::Keys);
+
+  auto taken = takeAll(queue);
+  ASSERT_EQ(taken.size(), 2);
+  EXPECT_EQ(taken[0].report_id, boot_keyboard_id);
+  EXPECT_EQ(taken[1].report_id, boot_mouse_id);
+}
+
+TEST(PrioritizedReportQueue, BootMouseClick) {
+  PrioritizedQueue queue;
+  const uint8_t keys = 0b01;
+  queue.push(boot_keyboard_id, &keys, 1, ReportKind::Keys);
+  pushBootMouse(queue, 0, 5);
+  pushBootMouse(queue, 0, 5);
+  pushBootMouse(queue, 1, 0);
+  pushBootMouse(queue, 0, 0);
+
+  // The movement goes ahead of the click, and every mouse report keeps its ID.
+  auto taken = takeAll(queue);
+  ASSERT_EQ(taken.size(), 4);
+  EXPECT_EQ(taken[0].report_id, boot_keyboard_id);
+  EXPECT_THAT(taken[0].data, ElementsAre(0b01));
+  for (uint8_t i = 1; i < 4; i++)
+    EXPECT_EQ(taken[i].report_id, boot_mouse_id) << "report " << int(i);
+  EXPECT_THAT(taken[1].data, ElementsAre(0, 10, 0));
+  EXPECT_THAT(taken[2].data, ElementsAre(1, 0, 0));
+  EXPECT_THAT(taken[3].data, ElementsAre(0, 0, 0));
+}
+
+TEST(PrioritizedReportQueue, OnlyButtonChangesWaitForTheKeyQueue) {
+  PrioritizedQueue queue;
+  const uint8_t moving[3]   = {0, 1, 0};
+  const uint8_t clicking[3] = {1, 0, 0};
+  EXPECT_FALSE(queue.goesToKeyQueue(moving, ReportKind::RelativeMouse));
+  EXPECT_TRUE(queue.goesToKeyQueue(clicking, ReportKind::RelativeMouse));
+  EXPECT_FALSE(queue.goesToKeyQueue(clicking, ReportKind::AbsoluteMouse));
+  EXPECT_TRUE(queue.goesToKeyQueue(moving, ReportKind::Keys));
+}
+
+// -----------------------------------------------------------------------------
+// The stats of the HID driver's queues, as HardwareFocus sends them over
+// Focus. The simulated host never makes the driver queue anything, so the
+// reports are put in the virtual driver's queue directly.
+
+class HidQueueFocusCommand : public VirtualDeviceTest {};
+
+TEST_F(HidQueueFocusCommand, SendsTheDriverStats) {
+  std::string response = sim_.SendFocusCommand("hardware.hid_queue");
+  EXPECT_NE(response.find("0 0 0"), std::string::npos) << response;
+
+  auto &queue = Runtime.device().hid().reportQueue();
+  // The second key report is a repeat, which is left out, and the mouse report
+  // doesn't fit, and can't be combined with a key report, so the oldest one is
+  // dropped.
+  const uint8_t keys[] = {1, 1, 2, 3, 4};
+  for (uint8_t key : keys)
+    queue.push(keyboard_id, &key, 1, Coalesce::State);
+  const uint8_t click[5] = {1, 0, 0, 0, 0};
+  queue.push(mouse_id, click, sizeof(click), Coalesce::MouseDeltas);
+  EXPECT_TRUE(Runtime.device().hid().hasQueuedReports());
+
+  response = sim_.SendFocusCommand("hardware.hid_queue");
+  EXPECT_NE(response.find("4 1 1"), std::string::npos) << response;
+
+  queue.clear();
+  queue.resetCounts();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
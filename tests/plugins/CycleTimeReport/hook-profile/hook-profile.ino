@@ -0,0 +1,73 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define KALEIDOSCOPE_HOOK_PROFILING 1
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-CycleTimeReport.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+namespace kaleidoscope {
+namespace plugin {
+
+// Implements two hooks, and none of the others.
+class CycleCounter : public Plugin {
+ public:
+  EventHandlerResult beforeEachCycle() {
+    return EventHandlerResult::OK;
+  }
+  EventHandlerResult onKeyEvent(KeyEvent &event) {
+    return EventHandlerResult::OK;
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::CycleCounter CycleCounter;
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(Focus, CycleTimeReport, CycleCounter);
+
+void setup() {
+  Kaleidoscope.setup();
+  // Keep the periodic cycle time reports out of the Focus responses.
+  CycleTimeReport.setReportInterval(60000);
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
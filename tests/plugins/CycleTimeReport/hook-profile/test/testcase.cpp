@@ -0,0 +1,102 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/hook_profile.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// Positions of the plugins in the sketch's KALEIDOSCOPE_INIT_PLUGINS() list.
+constexpr uint8_t cycle_time_report_plugin = 1;
+constexpr uint8_t cycle_counter_plugin     = 2;
+
+class HookProfile : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    hook_profile::reset();
+  }
+
+  uint32_t Calls(uint8_t plugin, hook_profile::Hook hook) {
+    return hook_profile::stats(plugin, hook).calls;
+  }
+};
+
+TEST_F(HookProfile, PluginsAreListedInOrder) {
+  ASSERT_EQ(hook_profile::pluginCount(), 3);
+
+  char name[32];
+  hook_profile::pluginName(0, name, sizeof(name));
+  EXPECT_STREQ(name, "Focus");
+  hook_profile::pluginName(1, name, sizeof(name));
+  EXPECT_STREQ(name, "CycleTimeReport");
+  hook_profile::pluginName(2, name, sizeof(name));
+  EXPECT_STREQ(name, "CycleCounter");
+
+  hook_profile::pluginName(2, name, 6);
+  EXPECT_STREQ(name, "Cycle");
+
+  hook_profile::hookName(hook_profile::beforeEachCycle, name, sizeof(name));
+  EXPECT_STREQ(name, "beforeEachCycle");
+}
+
+TEST_F(HookProfile, CallsAreCountedPerPluginAndHook) {
+  sim_.RunCycles(10);
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::beforeEachCycle), 10);
+  EXPECT_EQ(Calls(cycle_time_report_plugin, hook_profile::beforeEachCycle), 10);
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::onKeyEvent), 0);
+
+  sim_.Press(0, 0);
+  RunCycle();
+  sim_.Release(0, 0);
+  RunCycle();
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::onKeyEvent), 2);
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::beforeEachCycle), 12);
+
+  // Hooks that a plugin doesn't implement aren't recorded.
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::afterEachCycle), 0);
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::onAddToReport), 0);
+
+  hook_profile::HookStats stats =
+    hook_profile::stats(cycle_counter_plugin, hook_profile::beforeEachCycle);
+  EXPECT_LE(stats.max_us, stats.total_us);
+
+  hook_profile::reset();
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::beforeEachCycle), 0);
+}
+
+TEST_F(HookProfile, FocusCommands) {
+  sim_.RunCycles(5);
+  std::string response = sim_.SendFocusCommand("profile.hooks");
+  EXPECT_NE(response.find("CycleCounter beforeEachCycle "), std::string::npos)
+    << response;
+  EXPECT_EQ(response.find("CycleCounter onKeyEvent "), std::string::npos)
+    << response;
+
+  sim_.SendFocusCommand("profile.reset");
+  EXPECT_EQ(Calls(cycle_counter_plugin, hook_profile::onKeyEvent), 0);
+  EXPECT_LE(Calls(cycle_counter_plugin, hook_profile::beforeEachCycle), 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,118 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+
+#include "kaleidoscope/latency_histogram.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class LatencyHistogram : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    latency_histogram::reset();
+  }
+
+  void TearDown() override {
+    sim_.Release(0, 0);
+    sim_.Release(0, 1);
+    RunCycle();
+    VirtualDeviceTest::TearDown();
+  }
+};
+
+TEST_F(LatencyHistogram, StartsEmpty) {
+  EXPECT_EQ(latency_histogram::bucketCount(), 32);
+  EXPECT_EQ(latency_histogram::bucketMicros(), 500);
+
+  sim_.RunCycles(10);
+  EXPECT_EQ(latency_histogram::count(), 0);
+  EXPECT_EQ(latency_histogram::maxMicros(), 0);
+  EXPECT_EQ(latency_histogram::percentile(50), 0);
+}
+
+TEST_F(LatencyHistogram, KeyswitchEventsAreRecorded) {
+  sim_.Press(0, 0);
+  RunCycle();
+  EXPECT_EQ(latency_histogram::count(), 1);
+
+  // Holding the key doesn't send any more reports.
+  sim_.RunCycles(5);
+  EXPECT_EQ(latency_histogram::count(), 1);
+
+  sim_.Release(0, 0);
+  RunCycle();
+  EXPECT_EQ(latency_histogram::count(), 2);
+}
+
+TEST_F(LatencyHistogram, LatencyCountsFromDetection) {
+  // The scanner saw the press 3ms before the start of the last cycle, so by
+  // the time its report is sent, at least that much time has passed.
+  sim_.PressAt(KeyAddr(uint8_t(1)), Runtime.microsAtCycleStart() - 3000);
+  RunCycle();
+
+  ASSERT_EQ(latency_histogram::count(), 1);
+  uint32_t latency = latency_histogram::maxMicros();
+  EXPECT_GE(latency, 3000);
+  EXPECT_EQ(latency_histogram::bucket(latency / 500), 1);
+  EXPECT_EQ(latency_histogram::percentile(50), (latency / 500 + 1) * 500);
+}
+
+TEST_F(LatencyHistogram, Percentiles) {
+  for (uint8_t i = 0; i < 98; ++i)
+    latency_histogram::record(1200);
+  latency_histogram::record(9100);
+  latency_histogram::record(9400);
+
+  EXPECT_EQ(latency_histogram::count(), 100);
+  EXPECT_EQ(latency_histogram::bucket(2), 98);
+  EXPECT_EQ(latency_histogram::bucket(18), 2);
+  EXPECT_EQ(latency_histogram::percentile(50), 1500);
+  EXPECT_EQ(latency_histogram::percentile(98), 1500);
+  EXPECT_EQ(latency_histogram::percentile(99), 9500);
+  EXPECT_EQ(latency_histogram::percentile(100), 9500);
+
+  // Latencies beyond the last bucket end up in it, and percentiles that fall
+  // in it are reported as the longest latency seen.
+  latency_histogram::record(40000);
+  EXPECT_EQ(latency_histogram::bucket(31), 1);
+  EXPECT_EQ(latency_histogram::maxMicros(), 40000);
+  EXPECT_EQ(latency_histogram::percentile(100), 40000);
+  EXPECT_EQ(latency_histogram::percentile(50), 1500);
+}
+
+TEST_F(LatencyHistogram, FocusCommands) {
+  latency_histogram::record(1200);
+  latency_histogram::record(1300);
+
+  std::string response = sim_.SendFocusCommand("profile.latency");
+  EXPECT_NE(response.find("2 1500 1500 1300\n500 0 0 2 0 "), std::string::npos)
+    << response;
+
+  sim_.SendFocusCommand("profile.reset");
+  EXPECT_EQ(latency_histogram::count(), 0);
+  EXPECT_EQ(latency_histogram::bucket(2), 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
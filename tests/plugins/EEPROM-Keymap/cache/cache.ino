@@ -0,0 +1,52 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-EEPROM-Keymap.h>
+#include <Kaleidoscope-EEPROM-Settings.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_0, Key_1, Key_2, Key_3, Key_4, Key_5, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX,
+        XXX,
+
+        XXX, XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX, XXX, XXX, XXX,
+        XXX, XXX, XXX, XXX,
+        XXX
+    ),
+)
+// *INDENT-ON*
+
+KALEIDOSCOPE_INIT_PLUGINS(EEPROMSettings, EEPROMKeymap, Focus);
+
+void setup() {
+  Kaleidoscope.setup();
+  EEPROMKeymap.setup(2);
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
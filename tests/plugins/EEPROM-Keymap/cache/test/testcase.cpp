@@ -0,0 +1,114 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-EEPROM-Keymap.h>
+#include <Kaleidoscope-EEPROM-Settings.h>
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class EEPROMKeymapCache : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    // Start every test from an empty custom keymap.
+    for (uint16_t i = 0; i < 2 * 2 * Runtime.device().numKeys(); ++i) {
+      Runtime.storage().update(::EEPROMKeymap.keymap_base() + i, 0xff);
+    }
+    ::EEPROMSettings.storageChanged();
+    Layer.updateLayerCoverage();
+  }
+
+  // Read a custom keymap entry the slow way, bypassing the cache.
+  Key StoredKey(uint8_t layer, KeyAddr key_addr) {
+    uint16_t pos = ::EEPROMKeymap.keymap_base() +
+                   ((layer * Runtime.device().numKeys()) + key_addr.toInt()) * 2;
+    return Key(Runtime.storage().read(pos + 1), Runtime.storage().read(pos));
+  }
+
+  void CheckCustomLayers() {
+    for (uint8_t layer = 0; layer < 2; ++layer) {
+      for (KeyAddr key_addr : KeyAddr::all()) {
+        ASSERT_EQ(::EEPROMKeymap.getKey(layer, key_addr), StoredKey(layer, key_addr))
+          << "Wrong key " << int(key_addr.toInt()) << " on layer " << int(layer);
+      }
+    }
+  }
+};
+
+TEST_F(EEPROMKeymapCache, FocusWritesThrough) {
+  CheckCustomLayers();
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 1}), Key_Transparent);
+
+  // The first three keys of the first custom layer become A, B & C.
+  sim_.SendFocusCommand("keymap.custom 4 5 6");
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 0}), Key_A);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 2}), Key_C);
+  CheckCustomLayers();
+
+  // The custom layer comes after the PROGMEM one.
+  Layer.activate(1);
+  sim_.Press(0, 1);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_B.getKeyCode()));
+  sim_.Release(0, 1);
+  RunCycle();
+
+  // A transparent entry falls through to the PROGMEM layer.
+  sim_.Press(0, 4);
+  state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_4.getKeyCode()));
+  sim_.Release(0, 4);
+  RunCycle();
+}
+
+TEST_F(EEPROMKeymapCache, UpdateKeyWritesThrough) {
+  CheckCustomLayers();
+  uint16_t base_pos = Runtime.device().numKeys() + KeyAddr{1, 2}.toInt();
+  ::EEPROMKeymap.updateKey(base_pos, Key_X);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{1, 2}), Key_X);
+  CheckCustomLayers();
+}
+
+TEST_F(EEPROMKeymapCache, StorageChanged) {
+  CheckCustomLayers();
+
+  // Change storage behind the plugin's back, then report it.
+  uint16_t pos = ::EEPROMKeymap.keymap_base() + KeyAddr{2, 3}.toInt() * 2;
+  Runtime.storage().update(pos, Key_Y.getFlags());
+  Runtime.storage().update(pos + 1, Key_Y.getKeyCode());
+  ::EEPROMSettings.storageChanged();
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{2, 3}), Key_Y);
+  CheckCustomLayers();
+
+  Runtime.storage().update(pos + 1, Key_Z.getKeyCode());
+  ::EEPROMKeymap.invalidateCache();
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{2, 3}), Key_Z);
+  CheckCustomLayers();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,83 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-LEDControl.h>
+
+#include "kaleidoscope/Scheduler.h"
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class IdleLEDsTimer : public VirtualDeviceTest {};
+
+TEST_F(IdleLEDsTimer, TheSchedulerKnowsTheDeadline) {
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), 1000);
+
+  sim_.RunForMillis(400);
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+  EXPECT_EQ(Scheduler::millisUntilNextDeadline(), 1000);
+}
+
+TEST_F(IdleLEDsTimer, LEDsTurnOffAfterTheLimit) {
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+  ASSERT_TRUE(::LEDControl.isEnabled());
+
+  sim_.RunForMillis(990);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(20);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+
+  // The next key event turns them back on, and starts over.
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+}
+
+TEST_F(IdleLEDsTimer, TicklessIdleWakesUpForTheTimeout) {
+  Runtime.setMaxIdleTime(60000);
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+  uint32_t released_at = Runtime.millisAtCycleStart();
+
+  while (::LEDControl.isEnabled() && Runtime.millisAtCycleStart() - released_at < 60000)
+    RunCycle();
+  EXPECT_FALSE(::LEDControl.isEnabled());
+  EXPECT_LE(Runtime.millisAtCycleStart() - released_at, 1002);
+
+  Runtime.setMaxIdleTime(0);
+  sim_.Press(KeyAddr{0, 0});
+  RunCycle();
+  sim_.Release(KeyAddr{0, 0});
+  RunCycle();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
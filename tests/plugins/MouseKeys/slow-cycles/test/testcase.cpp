@@ -0,0 +1,102 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2025  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <initializer_list>  // for initializer_list
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr key_addr_MoveRight{0, 3};
+constexpr KeyAddr key_addr_ScrollUp{1, 0};
+
+// Cursor and wheel movement, added up over all the mouse reports sent while
+// some keys are held.
+struct Movement {
+  int x       = 0;
+  int v       = 0;
+  int reports = 0;
+};
+
+class SlowCycles : public VirtualDeviceTest {
+ protected:
+  void TearDown() override {
+    sim_.SetCycleTime(1);
+    sim_.Release(key_addr_MoveRight);
+    sim_.Release(key_addr_ScrollUp);
+    RunCycle();
+  }
+
+  // Holds `key_addrs` for `hold_time` milliseconds, and checks that none of
+  // the reports sent in the meantime is empty.
+  Movement Hold(std::initializer_list<KeyAddr> key_addrs, uint16_t hold_time) {
+    Movement movement;
+    for (KeyAddr key_addr : key_addrs)
+      sim_.Press(key_addr);
+    uint32_t start = Runtime.millisAtCycleStart();
+    while (Runtime.millisAtCycleStart() - start < hold_time) {
+      auto state = RunCycle();
+      for (const auto &report : state->HIDReports()->Mouse()) {
+        movement.x += report.XAxis();
+        movement.v += report.VWheel();
+        movement.reports++;
+        EXPECT_TRUE(report.XAxis() != 0 || report.VWheel() != 0);
+      }
+    }
+    for (KeyAddr key_addr : key_addrs)
+      sim_.Release(key_addr);
+    RunCycle();
+    return movement;
+  }
+};
+
+TEST_F(SlowCycles, CursorSpeedDoesNotDependOnCycleTime) {
+  int fast_cycles = Hold({key_addr_MoveRight}, 600).x;
+  sim_.SetCycleTime(10);
+  int slow_cycles = Hold({key_addr_MoveRight}, 600).x;
+
+  ASSERT_GT(fast_cycles, 100);
+  // The first report goes out when the key is pressed, and the last cycle can
+  // end up to one cycle late, so allow for a bit of difference.
+  EXPECT_NEAR(slow_cycles, fast_cycles, fast_cycles / 20);
+}
+
+TEST_F(SlowCycles, WheelSpeedDoesNotDependOnCycleTime) {
+  // The wheel moves once on the key press, and once every 50ms after that.
+  sim_.SetCycleTime(1);
+  EXPECT_EQ(Hold({key_addr_ScrollUp}, 500).v, 10);
+  sim_.SetCycleTime(20);
+  EXPECT_EQ(Hold({key_addr_ScrollUp}, 500).v, 10);
+  // Several steps can be due in a single cycle.
+  sim_.SetCycleTime(120);
+  EXPECT_EQ(Hold({key_addr_ScrollUp}, 500).v, 10);
+}
+
+TEST_F(SlowCycles, CursorAndWheelShareReports) {
+  sim_.SetCycleTime(10);
+  Movement movement = Hold({key_addr_MoveRight, key_addr_ScrollUp}, 200);
+  // One report per cycle, with the wheel steps in the ones they're due in.
+  EXPECT_EQ(movement.reports, 20);
+  EXPECT_EQ(movement.v, 4);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope